@@ -1,3 +1,7 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
 #include <utility>
 #include <vector>
 using std::size_t;
@@ -38,13 +42,28 @@ struct unweighted {
  *
  * Configurable to use weighted or unweighted edges.
  * Directed graphs only. TODO: Configure to swap between both types.
+ *
+ * The allocator is used for the edge lists and, rebound, for the list of
+ * vertices.
  */
-template <class EdgeType = unweighted> class adjacency_list {
+template <class EdgeType = unweighted,
+          class Allocator = std::allocator<EdgeType>>
+class adjacency_list {
+
+  typedef std::vector<EdgeType, Allocator> edge_list;
+  typedef typename std::allocator_traits<
+      Allocator>::template rebind_alloc<edge_list>
+      vertex_allocator;
 
-  std::vector<std::vector<EdgeType>> G;
+  std::vector<edge_list, vertex_allocator> G;
 
 public:
-  explicit adjacency_list(size_t N) : G(N) {}
+  typedef Allocator allocator_type;
+
+  explicit adjacency_list(size_t N, const Allocator &alloc = Allocator())
+      : G(N, edge_list(alloc), vertex_allocator(alloc)) {}
+
+  allocator_type get_allocator() const { return G.get_allocator(); }
 
   /**
    * Get number of nodes in graph
@@ -67,5 +86,11 @@ public:
    * @param a      Query node
    * @return All edges connected to query node
    */
-  const std::vector<EdgeType> &neighbors(size_t a) const { return G[a]; }
+  const edge_list &neighbors(size_t a) const { return G[a]; }
 };
+
+namespace pmr {
+template <class EdgeType = unweighted>
+using adjacency_list =
+    ::adjacency_list<EdgeType, std::pmr::polymorphic_allocator<EdgeType>>;
+} // namespace pmr
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "trie.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Aho-Corasick automaton for finding every occurrence of a set of patterns.
+ *
+ * The goto function and failure links are resolved at construction into a
+ * dense transition table, one row per state, flattened into a single array.
+ * Matching is then a single table lookup per input byte no matter how many
+ * patterns there are.
+ *
+ * To keep the table small, bytes are mapped to equivalence classes first:
+ * every byte used by some pattern gets its own column, and all other bytes
+ * share column 0. If patterns use every byte, there is no shared column.
+ *
+ * Patterns are numbered in lexicographic order, which is the iteration order
+ * of the trie they were compiled from. The empty pattern is ignored.
+ */
+class aho_corasick {
+  typedef std::size_t size_t;
+  typedef std::uint32_t state_type;
+
+  static constexpr state_type none = static_cast<state_type>(-1);
+  static constexpr state_type flag = state_type(1) << 31; //!< Has output
+
+  std::vector<std::string> patterns_;
+  std::uint8_t classes_[256] = {}; //!< Column for each byte
+  size_t width_ = 0;               //!< Number of columns, at most 256
+  std::vector<state_type> delta_;  //!< Transition table, states x columns.
+                                   //!< Entries are the row offset of the
+                                   //!< target, plus flag if it has output
+  std::vector<state_type> out_;    //!< Pattern ending at each state, or none
+  std::vector<state_type> match_;  //!< First state with output on the failure
+                                   //!< chain, including itself, 0 if none
+  std::vector<state_type> link_;   //!< Next state with output on the failure
+                                   //!< chain, excluding itself, 0 if none
+
+  void build() {
+    for (const auto &p : patterns_)
+      for (const auto c : p)
+        classes_[static_cast<unsigned char>(c)] = 1;
+    for (const auto c : classes_)
+      if (!c)
+        width_ = 1; // Column 0 for unused bytes
+    for (auto &c : classes_)
+      if (c)
+        c = static_cast<std::uint8_t>(width_++);
+
+    // Goto function, with states numbered breadth-first so the shallow
+    // states that most input bytes land on are packed together. 0 means no
+    // edge, since no edge leads back to the root.
+    struct range {
+      size_t lo, hi, depth; //!< Patterns sharing the path to a state
+    };
+    delta_.assign(width_, 0);
+    out_.assign(1, none);
+    std::vector<range> level{{0, patterns_.size(), 0}};
+    for (size_t first = 0; !level.empty();) {
+      std::vector<range> next;
+      for (size_t k = 0; k < level.size(); ++k) {
+        const auto &r = level[k];
+        const auto row = (first + k) * width_;
+        auto i = r.lo;
+        if (i < r.hi && patterns_[i].size() == r.depth)
+          out_[first + k] = static_cast<state_type>(i++);
+        while (i < r.hi) {
+          const auto c = patterns_[i][r.depth];
+          auto j = i + 1;
+          while (j < r.hi && patterns_[j][r.depth] == c)
+            ++j;
+          delta_[row + classes_[static_cast<unsigned char>(c)]] =
+              static_cast<state_type>(out_.size());
+          delta_.resize(delta_.size() + width_, 0);
+          out_.push_back(none);
+          next.push_back({i, j, r.depth + 1});
+          i = j;
+        }
+      }
+      first += level.size();
+      level.swap(next);
+    }
+
+    // Failure links. States are already in breadth-first order, so every
+    // failure target is finished before it is needed.
+    const auto states = out_.size();
+    std::vector<state_type> fail(states, 0);
+    link_.assign(states, 0);
+    for (size_t r = 0; r < states; ++r) {
+      const auto row = r * width_;
+      const auto fail_row = fail[r] * width_;
+      for (size_t c = 0; c < width_; ++c) {
+        const auto s = delta_[row + c];
+        if (s > r) {
+          const auto f = r ? delta_[fail_row + c] : 0;
+          fail[s] = f;
+          link_[s] = out_[f] != none ? f : link_[f];
+        } else if (r) {
+          delta_[row + c] = delta_[fail_row + c];
+        }
+      }
+    }
+
+    match_.resize(states);
+    for (size_t s = 0; s < states; ++s)
+      match_[s] = out_[s] != none ? static_cast<state_type>(s) : link_[s];
+
+    // Store row offsets so the scan loop needs no multiply
+    if (states * width_ >= flag)
+      throw std::length_error("aho_corasick: too many states");
+    for (auto &d : delta_)
+      d = static_cast<state_type>(d * width_) | (match_[d] ? flag : 0);
+  }
+
+  template <class F>
+  state_type scan(state_type row, const char *data, size_t n, size_t offset,
+                  F &f) const {
+    const auto delta = delta_.data();
+    for (size_t i = 0; i < n; ++i) {
+      row = delta[row + classes_[static_cast<unsigned char>(data[i])]];
+      if (row & flag) {
+        row &= ~flag;
+        for (auto t = match_[row / width_]; t; t = link_[t]) {
+          const auto id = out_[t];
+          f(offset + i + 1 - patterns_[id].size(), static_cast<size_t>(id));
+        }
+      }
+    }
+    return row;
+  }
+
+public:
+  /**
+   * Incremental matcher that carries its state across calls, so matches that
+   * span chunk boundaries are still reported.
+   */
+  class stream {
+    const aho_corasick *ac_;
+    state_type state_ = 0; //!< Row offset of the current state
+    size_t offset_ = 0;
+
+  public:
+    explicit stream(const aho_corasick &ac) : ac_(&ac) {}
+
+    /**
+     * Scan the next chunk of input.
+     * @param data Chunk to scan
+     * @param n    Size of the chunk
+     * @param f    Called as f(position, pattern id) for each match, where
+     *             position is the offset of the match start in the stream
+     */
+    template <class F> void feed(const char *data, size_t n, F f) {
+      state_ = ac_->scan(state_, data, n, offset_, f);
+      offset_ += n;
+    }
+
+    template <class F> void feed(const std::string &s, F f) {
+      feed(s.data(), s.size(), f);
+    }
+
+    /**
+     * Get number of bytes consumed so far.
+     */
+    size_t offset() const noexcept { return offset_; }
+
+    /**
+     * Start a new, unrelated stream.
+     */
+    void reset() noexcept {
+      state_ = 0;
+      offset_ = 0;
+    }
+  };
+
+  /**
+   * Compile the words of a trie.
+   * @param t Trie holding the patterns
+   */
+  template <class Allocator>
+  explicit aho_corasick(const basic_trie<Allocator> &t) {
+    for (const auto &s : t)
+      if (!s.empty())
+        patterns_.push_back(s);
+    build();
+  }
+
+  /**
+   * Find every match in a text with one pass.
+   * @param text Text to scan
+   * @param f    Called as f(position, pattern id) for each match
+   */
+  template <class F> void find_all(const std::string &text, F f) const {
+    scan(0, text.data(), text.size(), 0, f);
+  }
+
+  stream make_stream() const { return stream(*this); }
+
+  /**
+   * Get a pattern from its id.
+   * @param  id Pattern id
+   * @return    The pattern
+   */
+  const std::string &pattern(size_t id) const { return patterns_[id]; }
+
+  /**
+   * Get number of patterns.
+   */
+  size_t size() const noexcept { return patterns_.size(); }
+
+  /**
+   * Get number of automaton states.
+   */
+  size_t states() const noexcept { return out_.size(); }
+};
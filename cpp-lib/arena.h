@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+/**
+ * Monotonic arena memory resource.
+ *
+ * Allocation bumps a pointer through blocks taken from an upstream resource,
+ * and deallocation does nothing. Memory is handed back all at once by
+ * release() or the destructor, so tearing down every container built on the
+ * arena costs one call instead of one free per node.
+ *
+ * Otherwise this is std::pmr::monotonic_buffer_resource, and the one
+ * difference is why it exists: release() keeps the largest block for reuse,
+ * where monotonic_buffer_resource hands every block back upstream and starts
+ * again from its initial size. An arena that serves one request after
+ * another therefore stops touching the upstream resource once it has grown to
+ * fit the largest request.
+ *
+ * Not thread safe. Wrap it in std::pmr::synchronized_pool_resource to share
+ * it between threads.
+ */
+class arena : public std::pmr::memory_resource {
+  typedef std::size_t size_t;
+
+  struct block {
+    block *next;
+    size_t size; //!< Bytes including this header
+  };
+
+  std::pmr::memory_resource *upstream_;
+  block *blocks_ = nullptr; //!< Newest first
+  char *cur_ = nullptr;     //!< Next free byte of the newest block
+  char *end_ = nullptr;     //!< End of the newest block
+  size_t next_size_;        //!< Size of the next block to request
+  size_t used_ = 0;         //!< Bytes handed out since the last release
+
+  static char *align_up(char *p, size_t align) {
+    const auto v = reinterpret_cast<std::uintptr_t>(p);
+    return p + ((align - v % align) % align);
+  }
+
+  void grow(size_t bytes, size_t align) {
+    const auto size = std::max(next_size_, sizeof(block) + bytes + align);
+    const auto b = static_cast<block *>(
+        upstream_->allocate(size, alignof(std::max_align_t)));
+    b->next = blocks_;
+    b->size = size;
+    blocks_ = b;
+    cur_ = reinterpret_cast<char *>(b + 1);
+    end_ = reinterpret_cast<char *>(b) + size;
+    next_size_ = size * 2;
+  }
+
+  void free_blocks(block *b) {
+    while (b) {
+      const auto next = b->next;
+      upstream_->deallocate(b, b->size, alignof(std::max_align_t));
+      b = next;
+    }
+  }
+
+protected:
+  void *do_allocate(size_t bytes, size_t align) override {
+    if (cur_) {
+      const auto p = align_up(cur_, align);
+      if (p <= end_ && static_cast<size_t>(end_ - p) >= bytes) {
+        cur_ = p + bytes;
+        used_ += bytes;
+        return p;
+      }
+    }
+    grow(bytes, align);
+    const auto p = align_up(cur_, align);
+    cur_ = p + bytes;
+    used_ += bytes;
+    return p;
+  }
+
+  void do_deallocate(void *, size_t, size_t) override {}
+
+  bool do_is_equal(const memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+public:
+  /**
+   * Create an empty arena. No memory is taken until the first allocation.
+   * @param initial_size Size of the first block; later blocks double
+   * @param upstream     Resource the blocks come from
+   */
+  explicit arena(
+      size_t initial_size = 4096,
+      std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+      : upstream_(upstream),
+        next_size_(std::max(initial_size, 2 * sizeof(block))) {}
+
+  arena(const arena &) = delete;
+  arena &operator=(const arena &) = delete;
+
+  ~arena() override { free_blocks(blocks_); }
+
+  /**
+   * Free everything allocated from the arena at once. The largest block is
+   * kept and reused. Containers still using the arena must not be touched
+   * afterwards, other than to be destroyed.
+   */
+  void release() {
+    if (!blocks_)
+      return;
+    block *largest = blocks_;
+    for (auto b = blocks_; b; b = b->next)
+      if (b->size > largest->size)
+        largest = b;
+
+    // Unlink the largest block and free the rest
+    block **link = &blocks_;
+    while (*link != largest)
+      link = &(*link)->next;
+    *link = largest->next;
+    free_blocks(blocks_);
+
+    largest->next = nullptr;
+    blocks_ = largest;
+    cur_ = reinterpret_cast<char *>(largest + 1);
+    end_ = reinterpret_cast<char *>(largest) + largest->size;
+    used_ = 0;
+  }
+
+  /**
+   * Get bytes handed out since the arena was created or last released.
+   */
+  size_t used() const noexcept { return used_; }
+
+  /**
+   * Get bytes held from the upstream resource.
+   */
+  size_t capacity() const noexcept {
+    size_t total = 0;
+    for (auto b = blocks_; b; b = b->next)
+      total += b->size;
+    return total;
+  }
+
+  std::pmr::memory_resource *upstream_resource() const noexcept {
+    return upstream_;
+  }
+};
@@ -0,0 +1,393 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Sorted set of unsigned integers, compressed for dense id sets.
+ *
+ * Values are split into blocks of up to 128. Each block has a header holding
+ * its first value, and the gaps between the rest are stored bitpacked at the
+ * width of the largest gap in the block. A run of consecutive ids therefore
+ * takes only its 16 byte header per 128 values, and ids spread 1 in 16 take
+ * about 5 bits each.
+ *
+ * Lookups binary search the headers and then decode one block up to the
+ * value. Iteration decodes each gap once. Inserting or erasing rewrites one
+ * block and shifts the packed data after it, which is linear like flat_set,
+ * so build large sets from a range instead.
+ *
+ * Iterators are invalidated by any insertion or erasure.
+ */
+template <class T = std::uint64_t> class compressed_flat_set {
+  static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value,
+                "compressed_flat_set holds unsigned integers");
+
+  typedef std::uint64_t word;
+
+  struct block {
+    T first;              //!< Smallest value in the block
+    std::uint32_t offset; //!< First word of the packed gaps
+    std::uint8_t count;   //!< Number of values, including first
+    std::uint8_t width;   //!< Bits per packed gap
+  };
+
+  static constexpr std::size_t block_size = 128;
+
+  std::vector<block> blocks_;
+  std::vector<word> words_;
+  std::size_t size_ = 0;
+
+  static std::size_t words(std::size_t count, std::size_t width) {
+    return ((count - 1) * width + 63) / 64;
+  }
+
+  /**
+   * Get a packed gap, which is one less than the difference between the
+   * value at index i + 1 and the value at index i in its block.
+   */
+  word gap(const block &b, std::size_t i) const {
+    if (!b.width)
+      return 0;
+    const auto bit = i * b.width;
+    const auto w = &words_[b.offset + bit / 64];
+    const auto shift = bit % 64;
+    auto v = w[0] >> shift;
+    if (shift + b.width > 64)
+      v |= w[1] << (64 - shift);
+    return b.width == 64 ? v : v & ((word(1) << b.width) - 1);
+  }
+
+  /**
+   * Pack sorted, unique values as a block, appending the gaps to out.
+   */
+  static block encode(const T *v, std::size_t n, std::vector<word> &out) {
+    word all = 0;
+    for (std::size_t i = 1; i < n; ++i)
+      all |= word(v[i] - v[i - 1] - 1);
+    const auto width = all ? 64 - __builtin_clzll(all) : 0;
+
+    const block b{v[0], static_cast<std::uint32_t>(out.size()),
+                  static_cast<std::uint8_t>(n),
+                  static_cast<std::uint8_t>(width)};
+    const auto base = out.size();
+    out.resize(base + words(n, width), 0);
+    for (std::size_t i = 1, bit = 0; width && i < n; ++i, bit += width) {
+      const word g = v[i] - v[i - 1] - 1;
+      const auto shift = bit % 64;
+      out[base + bit / 64] |= g << shift;
+      if (shift + width > 64)
+        out[base + bit / 64 + 1] |= g >> (64 - shift);
+    }
+    return b;
+  }
+
+  /**
+   * Unpack the values of a block.
+   * @return Number of values
+   */
+  std::size_t decode(std::size_t b, T *out) const {
+    const auto &h = blocks_[b];
+    out[0] = h.first;
+    for (std::size_t i = 1; i < h.count; ++i)
+      out[i] = static_cast<T>(out[i - 1] + gap(h, i - 1) + 1);
+    return h.count;
+  }
+
+  /**
+   * Find the first value in a block that is not less than val.
+   * @param  h   Block to search
+   * @param  val Value to search for
+   * @param  v   Set to the value found
+   * @return     Index of the value found, or the block count if there is none
+   */
+  std::size_t scan(const block &h, T val, T &v) const {
+    v = h.first;
+    if (v >= val)
+      return 0;
+    if (!h.width) {
+      // Consecutive values
+      const auto i = static_cast<std::size_t>(val - h.first);
+      if (i >= h.count)
+        return h.count;
+      v = val;
+      return i;
+    }
+    const auto w = words_.data() + h.offset;
+    const auto mask = h.width == 64 ? ~word(0) : (word(1) << h.width) - 1;
+    for (std::size_t i = 1, bit = 0; i < h.count; ++i, bit += h.width) {
+      const auto shift = bit % 64;
+      auto g = w[bit / 64] >> shift;
+      if (shift + h.width > 64)
+        g |= w[bit / 64 + 1] << (64 - shift);
+      v = static_cast<T>(v + (g & mask) + 1);
+      if (v >= val)
+        return i;
+    }
+    return h.count;
+  }
+
+  /**
+   * Replace block b with the given values, splitting it in two if they do
+   * not fit in one block or removing it if there are none.
+   */
+  void rewrite(std::size_t b, const T *v, std::size_t n) {
+    std::vector<word> packed;
+    std::vector<block> added;
+    if (n > block_size) {
+      added.push_back(encode(v, n / 2, packed));
+      added.push_back(encode(v + n / 2, n - n / 2, packed));
+    } else if (n) {
+      added.push_back(encode(v, n, packed));
+    }
+
+    const auto base = blocks_[b].offset;
+    const auto old = words(blocks_[b].count, blocks_[b].width);
+    if (packed.size() > old)
+      words_.insert(words_.begin() + base + old, packed.size() - old, 0);
+    else
+      words_.erase(words_.begin() + base + packed.size(),
+                   words_.begin() + base + old);
+    std::copy(packed.begin(), packed.end(), words_.begin() + base);
+
+    for (auto &h : added)
+      h.offset += base;
+    for (auto i = b + 1; i < blocks_.size(); ++i)
+      blocks_[i].offset = static_cast<std::uint32_t>(blocks_[i].offset +
+                                                     packed.size() - old);
+    blocks_.erase(blocks_.begin() + b);
+    blocks_.insert(blocks_.begin() + b, added.begin(), added.end());
+  }
+
+  /**
+   * Find the block that holds, or would hold, a value.
+   */
+  std::size_t find_block(T val) const {
+    const auto it =
+        std::upper_bound(blocks_.begin(), blocks_.end(), val,
+                         [](T v, const block &h) { return v < h.first; });
+    return it == blocks_.begin() ? 0 : it - blocks_.begin() - 1;
+  }
+
+  void build(const std::vector<T> &v) {
+    blocks_.clear();
+    words_.clear();
+    blocks_.reserve((v.size() + block_size - 1) / block_size);
+    for (std::size_t i = 0; i < v.size(); i += block_size)
+      blocks_.push_back(encode(v.data() + i,
+                               std::min(block_size, v.size() - i), words_));
+    words_.shrink_to_fit();
+    size_ = v.size();
+  }
+
+public:
+  // Types
+  typedef std::size_t size_type;
+  typedef T value_type;
+
+  /**
+   * Forward iterator decoding one gap per step.
+   */
+  class const_iterator {
+    friend class compressed_flat_set;
+
+    const compressed_flat_set *s_ = nullptr;
+    std::size_t block_ = 0; //!< Block index, the number of blocks at the end
+    std::size_t i_ = 0;     //!< Index within the block
+    T value_ = 0;
+
+    const_iterator(const compressed_flat_set *s, std::size_t b, std::size_t i,
+                   T value)
+        : s_(s), block_(b), i_(i), value_(value) {}
+
+    // Start of a block, or the end if there is none
+    const_iterator(const compressed_flat_set *s, std::size_t b)
+        : s_(s), block_(b) {
+      if (b < s->blocks_.size())
+        value_ = s->blocks_[b].first;
+    }
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T *pointer;
+    typedef const T &reference;
+
+    const_iterator() = default;
+
+    reference operator*() const { return value_; }
+    pointer operator->() const { return &value_; }
+
+    const_iterator &operator++() {
+      const auto &h = s_->blocks_[block_];
+      if (++i_ < h.count) {
+        value_ = static_cast<T>(value_ + s_->gap(h, i_ - 1) + 1);
+      } else {
+        i_ = 0;
+        if (++block_ < s_->blocks_.size())
+          value_ = s_->blocks_[block_].first;
+      }
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    friend bool operator==(const const_iterator &a, const const_iterator &b) {
+      return a.block_ == b.block_ && a.i_ == b.i_;
+    }
+
+    friend bool operator!=(const const_iterator &a, const const_iterator &b) {
+      return !(a == b);
+    }
+  };
+  typedef const_iterator iterator;
+
+  // Constructors
+  compressed_flat_set() = default;
+
+  /**
+   * Build a set from a range in one pass. The range is sorted and
+   * deduplicated first if it is not already.
+   * @param first Start of the values
+   * @param last  End of the values
+   */
+  template <class InputIt> compressed_flat_set(InputIt first, InputIt last) {
+    std::vector<T> v(first, last);
+    if (!std::is_sorted(v.begin(), v.end()))
+      std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+    build(v);
+  }
+
+  compressed_flat_set(std::initializer_list<T> values)
+      : compressed_flat_set(values.begin(), values.end()) {}
+
+  friend void swap(compressed_flat_set &a, compressed_flat_set &b) {
+    a.swap(b);
+  }
+
+  // Iterators
+  const_iterator begin() const noexcept { return const_iterator(this, 0); }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator end() const noexcept {
+    return const_iterator(this, blocks_.size());
+  }
+  const_iterator cend() const noexcept { return end(); }
+
+  // Capacity Checks
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+
+  /**
+   * Get the bytes used by the set, including unused vector capacity.
+   */
+  size_type memory_usage() const noexcept {
+    return sizeof(*this) + blocks_.capacity() * sizeof(block) +
+           words_.capacity() * sizeof(word);
+  }
+
+  /**
+   * Release unused vector capacity, as left behind by insert and erase.
+   */
+  void shrink_to_fit() {
+    blocks_.shrink_to_fit();
+    words_.shrink_to_fit();
+  }
+
+  // Modifiers
+
+  void clear() noexcept {
+    blocks_.clear();
+    words_.clear();
+    size_ = 0;
+  }
+
+  std::pair<iterator, bool> insert(const value_type &val) {
+    if (blocks_.empty()) {
+      blocks_.push_back(encode(&val, 1, words_));
+      ++size_;
+      return {begin(), true};
+    }
+
+    const auto b = find_block(val);
+    T v[block_size + 1];
+    const auto n = decode(b, v);
+    const auto pos = std::lower_bound(v, v + n, val) - v;
+    if (static_cast<std::size_t>(pos) < n && v[pos] == val)
+      return {const_iterator(this, b, pos, val), false};
+
+    std::copy_backward(v + pos, v + n, v + n + 1);
+    v[pos] = val;
+    rewrite(b, v, n + 1);
+    ++size_;
+    if (n + 1 > block_size && static_cast<std::size_t>(pos) >= (n + 1) / 2)
+      return {const_iterator(this, b + 1, pos - (n + 1) / 2, val), true};
+    return {const_iterator(this, b, pos, val), true};
+  }
+
+  size_type erase(const value_type &val) {
+    if (blocks_.empty())
+      return 0;
+    const auto b = find_block(val);
+    T v[block_size];
+    const auto n = decode(b, v);
+    const auto it = std::lower_bound(v, v + n, val);
+    if (it == v + n || *it != val)
+      return 0;
+    std::copy(it + 1, v + n, it);
+    rewrite(b, v, n - 1);
+    --size_;
+    return 1;
+  }
+
+  void swap(compressed_flat_set &x) noexcept {
+    blocks_.swap(x.blocks_);
+    words_.swap(x.words_);
+    std::swap(size_, x.size_);
+  }
+
+  // Operations
+
+  const_iterator find(const value_type &val) const {
+    const auto it = lower_bound(val);
+    if (it == end() || *it == val)
+      return it;
+    return end();
+  }
+
+  size_type count(const value_type &val) const { return find(val) != end(); }
+
+  const_iterator lower_bound(const value_type &val) const {
+    if (blocks_.empty() || val < blocks_[0].first)
+      return begin();
+    const auto b = find_block(val);
+    T v;
+    const auto i = scan(blocks_[b], val, v);
+    if (i == blocks_[b].count)
+      return const_iterator(this, b + 1);
+    return const_iterator(this, b, i, v);
+  }
+
+  const_iterator upper_bound(const value_type &val) const {
+    auto it = lower_bound(val);
+    if (it != end() && *it == val)
+      ++it;
+    return it;
+  }
+
+  std::pair<const_iterator, const_iterator>
+  equal_range(const value_type &val) const {
+    return {lower_bound(val), upper_bound(val)};
+  }
+};
@@ -0,0 +1,360 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Trie for read-mostly concurrent use.
+ *
+ * Readers never lock or retry: find and the prefix queries are wait-free.
+ * Published nodes are never modified. A writer copies the path from the root
+ * to the node it changes and then swaps in the new root with a single atomic
+ * store. Writers serialize on a mutex among themselves.
+ *
+ * Replaced nodes are reclaimed with epochs. Each reader announces the global
+ * epoch in its own cache line while it runs, and a writer frees a retired
+ * path only after every announced epoch is newer than the path's retirement.
+ * Readers therefore only write to memory no other thread reads on the fast
+ * path.
+ *
+ * At most max_threads threads may use tries at the same time.
+ */
+class concurrent_trie {
+  typedef std::size_t size_t;
+  typedef std::uint64_t epoch_type;
+
+  struct Node {
+    std::vector<std::pair<char, const Node *>> table; //!< Sorted children
+    size_t count = 0; //!< Number of words in this subtree
+    bool end = false;
+  };
+
+  static constexpr epoch_type idle = static_cast<epoch_type>(-1);
+
+public:
+  static constexpr size_t max_threads = 256;
+
+private:
+  struct alignas(64) slot {
+    std::atomic<epoch_type> epoch{idle}; //!< Epoch seen by an active reader
+  };
+
+  std::atomic<const Node *> root_{new Node};
+  std::atomic<epoch_type> epoch_{0};
+  mutable slot slots_[max_threads];
+
+  std::mutex write_; //!< Serializes writers, guards retired_
+  std::vector<std::pair<epoch_type, std::vector<const Node *>>> retired_;
+
+  /**
+   * Small per-thread index into slots_, shared by every trie. Indices are
+   * handed back when the thread exits.
+   */
+  static size_t thread_index() {
+    struct registration {
+      size_t index;
+      registration() {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        auto &used = registry();
+        const auto it = std::find(used.begin(), used.end(), false);
+        if (it == used.end())
+          throw std::runtime_error("concurrent_trie: too many threads");
+        *it = true;
+        index = static_cast<size_t>(it - used.begin());
+      }
+      ~registration() {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        registry()[index] = false;
+      }
+    };
+    thread_local registration r;
+    return r.index;
+  }
+
+  static std::mutex &registry_mutex() {
+    static std::mutex m;
+    return m;
+  }
+
+  static std::vector<bool> &registry() {
+    static std::vector<bool> used(max_threads, false);
+    return used;
+  }
+
+  /**
+   * Marks the calling thread as reading for its lifetime. Nested guards on
+   * the same trie and thread are allowed.
+   */
+  class read_guard {
+    std::atomic<epoch_type> &epoch_;
+    bool outer_;
+
+  public:
+    explicit read_guard(const concurrent_trie &t)
+        : epoch_(t.slots_[thread_index()].epoch),
+          outer_(epoch_.load(std::memory_order_relaxed) == idle) {
+      if (outer_)
+        epoch_.store(t.epoch_.load(std::memory_order_acquire));
+    }
+    ~read_guard() {
+      if (outer_)
+        epoch_.store(idle, std::memory_order_release);
+    }
+    read_guard(const read_guard &) = delete;
+    read_guard &operator=(const read_guard &) = delete;
+  };
+
+  static bool byte_less(char a, char b) {
+    return static_cast<unsigned char>(a) < static_cast<unsigned char>(b);
+  }
+
+  template <class Table> static auto lower_bound(Table &table, char c) {
+    return std::lower_bound(
+        table.begin(), table.end(), c,
+        [](const std::pair<char, const Node *> &p, char x) {
+          return byte_less(p.first, x);
+        });
+  }
+
+  static const Node *child(const Node *n, char c) {
+    const auto it = lower_bound(n->table, c);
+    return it != n->table.end() && it->first == c ? it->second : nullptr;
+  }
+
+  static const Node *find_node(const Node *n, const std::string &s) {
+    for (const auto c : s) {
+      n = child(n, c);
+      if (!n)
+        return nullptr;
+    }
+    return n;
+  }
+
+  /**
+   * Copy the path for a new word.
+   * @param  n       Node being replaced, or nullptr to create one
+   * @param  s       Word to insert
+   * @param  i       Iteration index
+   * @param  retired Collects the replaced nodes
+   * @return         Replacement node
+   */
+  static Node *insert_path(const Node *n, const std::string &s, size_t i,
+                           std::vector<const Node *> &retired) {
+    auto m = n ? new Node(*n) : new Node;
+    if (n)
+      retired.push_back(n);
+    ++m->count;
+    if (i == s.size()) {
+      m->end = true;
+      return m;
+    }
+    auto it = lower_bound(m->table, s[i]);
+    if (it != m->table.end() && it->first == s[i])
+      it->second = insert_path(it->second, s, i + 1, retired);
+    else
+      m->table.insert(it, {s[i], insert_path(nullptr, s, i + 1, retired)});
+    return m;
+  }
+
+  /**
+   * Copy the path for a removed word, dropping subtrees left empty.
+   * @param  n       Node being replaced
+   * @param  s       Word to erase, must be present
+   * @param  i       Iteration index
+   * @param  retired Collects the replaced nodes
+   * @return         Replacement node, or nullptr if the subtree is now empty
+   */
+  static Node *erase_path(const Node *n, const std::string &s, size_t i,
+                          std::vector<const Node *> &retired) {
+    retired.push_back(n);
+    if (n->count == 1 && i > 0) {
+      // Only this word is left below, so the rest of the path goes too
+      for (; i < s.size(); ++i) {
+        n = child(n, s[i]);
+        retired.push_back(n);
+      }
+      return nullptr;
+    }
+    auto m = new Node(*n);
+    --m->count;
+    if (i == s.size()) {
+      m->end = false;
+      return m;
+    }
+    auto it = lower_bound(m->table, s[i]);
+    if (const auto c = erase_path(it->second, s, i + 1, retired))
+      it->second = c;
+    else
+      m->table.erase(it);
+    return m;
+  }
+
+  /**
+   * Publish a new root and free whatever no reader can still see.
+   * Must be called with write_ held.
+   */
+  void publish(const Node *root, std::vector<const Node *> retired) {
+    root_.store(root);
+    retired_.emplace_back(epoch_.fetch_add(1), std::move(retired));
+
+    auto oldest = idle;
+    for (const auto &s : slots_)
+      oldest = std::min(oldest, s.epoch.load());
+    auto it = retired_.begin();
+    for (; it != retired_.end() && it->first < oldest; ++it)
+      for (const auto n : it->second)
+        delete n;
+    retired_.erase(retired_.begin(), it);
+  }
+
+  static void destroy(const Node *n) {
+    for (const auto &c : n->table)
+      destroy(c.second);
+    delete n;
+  }
+
+public:
+  concurrent_trie() = default;
+  concurrent_trie(const concurrent_trie &) = delete;
+  concurrent_trie &operator=(const concurrent_trie &) = delete;
+
+  /**
+   * Destroy the trie. No other thread may be using it.
+   */
+  ~concurrent_trie() {
+    for (const auto &r : retired_)
+      for (const auto n : r.second)
+        delete n;
+    destroy(root_.load());
+  }
+
+  /**
+   * Insert a new string into the container.
+   * @param  s String to insert
+   * @return   True if the string was not already present
+   */
+  bool insert(const std::string &s) {
+    std::lock_guard<std::mutex> lock(write_);
+    const auto root = root_.load(std::memory_order_relaxed);
+    const auto n = find_node(root, s);
+    if (n && n->end)
+      return false;
+    std::vector<const Node *> retired;
+    const auto r = insert_path(root, s, 0, retired);
+    publish(r, std::move(retired));
+    return true;
+  }
+
+  /**
+   * Remove a word from the trie.
+   * @param  s Word to remove
+   * @return   True if the word was present
+   */
+  bool erase(const std::string &s) {
+    std::lock_guard<std::mutex> lock(write_);
+    const auto root = root_.load(std::memory_order_relaxed);
+    const auto n = find_node(root, s);
+    if (!n || !n->end)
+      return false;
+    std::vector<const Node *> retired;
+    const auto r = erase_path(root, s, 0, retired);
+    publish(r, std::move(retired));
+    return true;
+  }
+
+  /**
+   * Test if a string is present in the container.
+   * @param  s String to test
+   * @return   Returns true if found
+   */
+  bool find(const std::string &s) const {
+    read_guard g(*this);
+    const auto n = find_node(root_.load(), s);
+    return n && n->end;
+  }
+
+  /**
+   * Count the words beginning with a prefix.
+   * @param  prefix Prefix to search for
+   * @return        Number of matching words
+   */
+  size_t count_prefix(const std::string &prefix) const {
+    read_guard g(*this);
+    const auto n = find_node(root_.load(), prefix);
+    return n ? n->count : 0;
+  }
+
+  /**
+   * Find the longest word in the trie that is a prefix of a string.
+   * @param  s String to match against
+   * @return   Length of the longest matching word, or std::string::npos if no
+   *           word matches
+   */
+  size_t longest_prefix_match(const std::string &s) const {
+    read_guard g(*this);
+    auto n = root_.load();
+    auto match = n->end ? 0 : std::string::npos;
+    for (size_t i = 0; i < s.size(); ++i) {
+      n = child(n, s[i]);
+      if (!n)
+        break;
+      if (n->end)
+        match = i + 1;
+    }
+    return match;
+  }
+
+  /**
+   * Visit every word beginning with a prefix, in lexicographic order. The
+   * words all come from one consistent version of the trie.
+   * @param prefix Prefix to search for
+   * @param f      Called as f(word) for each match
+   */
+  template <class F>
+  void for_each_prefix(const std::string &prefix, F f) const {
+    read_guard g(*this);
+    const auto start = find_node(root_.load(), prefix);
+    if (!start)
+      return;
+    struct frame {
+      const Node *node;
+      size_t next; //!< Next child to visit
+    };
+    std::vector<frame> stack{{start, 0}};
+    auto key = prefix;
+    if (start->end)
+      f(static_cast<const std::string &>(key));
+    while (!stack.empty()) {
+      auto &top = stack.back();
+      if (top.next == top.node->table.size()) {
+        stack.pop_back();
+        if (!stack.empty())
+          key.pop_back();
+        continue;
+      }
+      const auto &c = top.node->table[top.next++];
+      key.push_back(c.first);
+      stack.push_back({c.second, 0});
+      if (c.second->end)
+        f(static_cast<const std::string &>(key));
+    }
+  }
+
+  /**
+   * Get number of words.
+   * @return Number of words in the trie
+   */
+  size_t size() const {
+    read_guard g(*this);
+    return root_.load()->count;
+  }
+
+  bool empty() const { return size() == 0; }
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * Union Find data structure usable from many threads at once
+ *
+ * Lock-free implementation over a flat array of atomic parent pointers. Roots
+ * are linked by index: a root is only ever hung under a root with a smaller
+ * index, with a compare-and-swap that fails if it stopped being a root. So
+ * parents always have smaller indices than their children and no cycle can
+ * form however calls interleave.
+ *
+ * Paths are shortened with path halving. The halving writes are CASes that
+ * may lose races to other threads, which only costs some compression.
+ */
+class concurrent_union_find {
+  typedef std::size_t size_t;
+
+  std::unique_ptr<std::atomic<size_t>[]> v; //!< Root pointers
+  size_t n_;                                //!< Number of elements
+
+public:
+  explicit concurrent_union_find(size_t n)
+      : v(new std::atomic<size_t>[n]), n_(n) {
+    for (size_t i = 0; i < n; ++i)
+      v[i].store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * Find root of set for the given element, halving the path on the way.
+   * The result may be out of date by the time it is returned if other
+   * threads are uniting.
+   * @param  a Element to search for
+   * @return   Root ID associated with input Element
+   */
+  size_t root(size_t a) {
+    while (true) {
+      auto p = v[a].load(std::memory_order_acquire);
+      if (p == a)
+        return a;
+      const auto g = v[p].load(std::memory_order_acquire);
+      if (p != g)
+        v[a].compare_exchange_weak(p, g, std::memory_order_release,
+                                   std::memory_order_relaxed);
+      a = g;
+    }
+  }
+
+  /**
+   * Connect two elements.
+   * @param  a Element 1
+   * @param  b Element 2
+   * @return   True if they were in different sets before the call
+   */
+  bool unite(size_t a, size_t b) {
+    while (true) {
+      a = root(a);
+      b = root(b);
+      if (a == b)
+        return false;
+      if (a < b)
+        std::swap(a, b);
+      auto expected = a;
+      if (v[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel))
+        return true;
+    }
+  }
+
+  /**
+   * Check if two elements are in the same set
+   * @param  a Element 1
+   * @param  b Element 2
+   * @return   True if elements are connected
+   */
+  bool find(size_t a, size_t b) {
+    while (true) {
+      a = root(a);
+      b = root(b);
+      if (a == b)
+        return true;
+      // Roots differ. Only trust that if a was not linked in the meantime.
+      if (v[a].load(std::memory_order_acquire) == a)
+        return false;
+    }
+  }
+
+  /**
+   * Get number of elements.
+   * @return Number of elements in data structure
+   */
+  size_t size() const noexcept { return n_; }
+};
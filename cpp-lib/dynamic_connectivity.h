@@ -0,0 +1,128 @@
+#pragma once
+
+#include "rollback_union_find.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+/**
+ * Offline dynamic connectivity
+ *
+ * Records a batch of edge insertions, edge deletions and connectivity
+ * queries, then answers every query at once. Each edge is alive for an
+ * interval of queries; the intervals are stored in a segment tree over time
+ * and a depth first walk of the tree unites edges on the way down and rolls
+ * them back on the way up. Each edge lands in O(log q) tree nodes and each
+ * unite costs O(log n), so q operations take O(n + q log q log n) instead of
+ * rebuilding the sets for every query.
+ *
+ * Parallel edges are allowed; each removal deletes one copy.
+ */
+class dynamic_connectivity {
+  typedef std::size_t size_t;
+  typedef std::pair<size_t, size_t> edge;
+
+  size_t n_;
+  std::vector<edge> queries_;
+  std::map<edge, std::vector<size_t>> open_; //!< Live edges and start times
+  std::vector<std::pair<edge, edge>> closed_; //!< Edge and its query interval
+
+  static edge key(size_t a, size_t b) {
+    return a < b ? edge(a, b) : edge(b, a);
+  }
+
+  /**
+   * Add an edge to every segment tree node covering part of [lo, hi).
+   */
+  static void cover(std::vector<std::vector<edge>> &tree, size_t node,
+                    size_t l, size_t r, size_t lo, size_t hi, const edge &e) {
+    if (hi <= l || r <= lo)
+      return;
+    if (lo <= l && r <= hi) {
+      tree[node].push_back(e);
+      return;
+    }
+    const auto mid = l + (r - l) / 2;
+    cover(tree, 2 * node, l, mid, lo, hi, e);
+    cover(tree, 2 * node + 1, mid, r, lo, hi, e);
+  }
+
+  void solve(const std::vector<std::vector<edge>> &tree, size_t node, size_t l,
+             size_t r, rollback_union_find &uf,
+             std::vector<bool> &answers) const {
+    const auto mark = uf.checkpoint();
+    for (const auto &e : tree[node])
+      uf.unite(e.first, e.second);
+    if (r - l == 1) {
+      answers[l] = uf.find(queries_[l].first, queries_[l].second);
+    } else {
+      const auto mid = l + (r - l) / 2;
+      solve(tree, 2 * node, l, mid, uf, answers);
+      solve(tree, 2 * node + 1, mid, r, uf, answers);
+    }
+    uf.rollback(mark);
+  }
+
+public:
+  explicit dynamic_connectivity(size_t n) : n_(n) {}
+
+  /**
+   * Connect two nodes from this point on.
+   * @param a First node
+   * @param b Second node
+   */
+  void add_edge(size_t a, size_t b) {
+    open_[key(a, b)].push_back(queries_.size());
+  }
+
+  /**
+   * Remove an edge added earlier.
+   * @param  a First node
+   * @param  b Second node
+   * @return   False if there was no such edge
+   */
+  bool remove_edge(size_t a, size_t b) {
+    const auto it = open_.find(key(a, b));
+    if (it == open_.end())
+      return false;
+    closed_.push_back({it->first, {it->second.back(), queries_.size()}});
+    it->second.pop_back();
+    if (it->second.empty())
+      open_.erase(it);
+    return true;
+  }
+
+  /**
+   * Ask whether two nodes are connected at this point.
+   * @param  a First node
+   * @param  b Second node
+   * @return   Index of the answer in the result of solve
+   */
+  size_t query(size_t a, size_t b) {
+    queries_.emplace_back(a, b);
+    return queries_.size() - 1;
+  }
+
+  /**
+   * Answer every query recorded so far.
+   * @return Connectivity for each query, in the order they were asked
+   */
+  std::vector<bool> solve() const {
+    const auto q = queries_.size();
+    std::vector<bool> answers(q);
+    if (!q)
+      return answers;
+
+    std::vector<std::vector<edge>> tree(4 * q);
+    for (const auto &c : closed_)
+      cover(tree, 1, 0, q, c.second.first, c.second.second, c.first);
+    for (const auto &o : open_)
+      for (const auto start : o.second)
+        cover(tree, 1, 0, q, start, q, o.first);
+
+    rollback_union_find uf(n_);
+    solve(tree, 1, 0, q, uf, answers);
+    return answers;
+  }
+};
@@ -1,4 +1,8 @@
+#pragma once
+
 #include <algorithm>
+#include <memory>
+#include <memory_resource>
 #include <utility>
 #include <vector>
 
@@ -12,16 +16,17 @@
 // This is a re-write (essentially) of boost::flat_set
 // ****I'm not aware of any reason to use this instead of boost::flat_set
 
-template <class T> class flat_set {
+template <class T, class Allocator = std::allocator<T>> class flat_set {
 private:
-  std::vector<T> data_; //!< Data storage for the set
+  std::vector<T, Allocator> data_; //!< Data storage for the set
 
 public:
   // Types
   typedef std::size_t size_type;
   typedef T value_type;
-  typedef typename std::vector<T>::iterator iterator;
-  typedef typename std::vector<T>::const_iterator const_iterator;
+  typedef Allocator allocator_type;
+  typedef typename std::vector<T, Allocator>::iterator iterator;
+  typedef typename std::vector<T, Allocator>::const_iterator const_iterator;
 
   // Helper
   friend void swap(flat_set &first, flat_set &second) {
@@ -32,9 +37,18 @@ public:
   // Constructors
   flat_set() : data_() {}
 
+  explicit flat_set(const Allocator &alloc) : data_(alloc) {}
+
   flat_set(const flat_set &x) : data_(x.data_) {}
 
-  flat_set(flat_set &&x) : flat_set() { swap(*this, x); }
+  flat_set(const flat_set &x, const Allocator &alloc) : data_(x.data_, alloc) {}
+
+  flat_set(flat_set &&x) : data_(std::move(x.data_)) {}
+
+  flat_set(flat_set &&x, const Allocator &alloc)
+      : data_(std::move(x.data_), alloc) {}
+
+  allocator_type get_allocator() const { return data_.get_allocator(); }
 
   // Iterators
   //  These functions return iterators into the set
@@ -57,11 +71,9 @@ public:
   void clear() noexcept { data_.clear(); }
 
   std::pair<iterator, bool> insert(const value_type &val) {
-    auto it = find(val);
-    if (it == data_.end() || *it != val) {
-      data_.insert(it, val);
-      return {it, true};
-    }
+    auto it = lower_bound(val);
+    if (it == data_.end() || *it != val)
+      return {data_.insert(it, val), true};
     return {it, false};
   }
 
@@ -73,7 +85,7 @@ public:
     return 1;
   }
 
-  void swap(flat_set &x) { swap(*this, x); }
+  void swap(flat_set &x) { data_.swap(x.data_); }
 
   // Operations
 
@@ -120,3 +132,8 @@ public:
     return std::equal_range(data_.cbegin(), data_.cend(), val);
   }
 };
+
+namespace pmr {
+template <class T>
+using flat_set = ::flat_set<T, std::pmr::polymorphic_allocator<T>>;
+}
@@ -1,6 +1,12 @@
 // Clone of std::priority_queue
 
+#pragma once
+
 #include <functional>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 template <class T, class Container = std::vector<T>,
@@ -10,6 +16,10 @@ class heap {
   Container data_;
   Compare cmp_ = Compare();
 
+  template <class Alloc>
+  using if_allocator = typename std::enable_if<
+      std::uses_allocator<Container, Alloc>::value>::type;
+
 public:
   // Types
   typedef T value_type;
@@ -19,6 +29,26 @@ public:
   typedef typename Container::reference reference;
   typedef typename Container::const_reference const_reference;
 
+  heap() = default;
+
+  explicit heap(const Compare &cmp) : cmp_(cmp) {}
+
+  // Allocator-extended constructors, passing the allocator to the container
+  template <class Alloc, class = if_allocator<Alloc>>
+  explicit heap(const Alloc &alloc) : data_(alloc) {}
+
+  template <class Alloc, class = if_allocator<Alloc>>
+  heap(const Compare &cmp, const Alloc &alloc) : data_(alloc), cmp_(cmp) {}
+
+  template <class Alloc, class = if_allocator<Alloc>>
+  heap(const heap &other, const Alloc &alloc)
+      : data_(other.data_, alloc), cmp_(other.cmp_) {}
+
+  template <class Alloc, class = if_allocator<Alloc>>
+  heap(heap &&other, const Alloc &alloc)
+      : data_(std::move(other.data_), alloc),
+        cmp_(std::move(other.cmp_)) {}
+
   const_reference top() const { return data_.front(); }
 
   bool empty() const { return data_.empty(); }
@@ -90,3 +120,14 @@ private:
     }
   }
 };
+
+namespace std {
+template <class T, class Container, class Compare, class Alloc>
+struct uses_allocator<heap<T, Container, Compare>, Alloc>
+    : uses_allocator<Container, Alloc>::type {};
+} // namespace std
+
+namespace pmr {
+template <class T, class Compare = std::less<T>>
+using heap = ::heap<T, std::pmr::vector<T>, Compare>;
+}
@@ -1,4 +1,10 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
 #include <list>
+#include <memory>
+#include <memory_resource>
 #include <unordered_map>
 #include <utility>
 
@@ -7,14 +13,27 @@
  *
  * Stores key/value pairs, while keeping track of the least recently accessed
  * key for removal once the size is exceeded.
+ *
+ * The allocator is rebound for both the recency list and the hash map, so
+ * every node the cache creates comes from it.
  */
-template <class Key, class Value> class lru_cache {
+template <class Key, class Value, class Hash = std::hash<Key>,
+          class KeyEqual = std::equal_to<Key>,
+          class Allocator = std::allocator<std::pair<const Key, Value>>>
+class lru_cache {
 
   typedef Key key_type;
   typedef Value value_type;
-  typedef std::list<key_type> list_type;
+  typedef std::allocator_traits<Allocator> alloc_traits;
+  typedef std::list<key_type,
+                    typename alloc_traits::template rebind_alloc<key_type>>
+      list_type;
+  typedef std::pair<const key_type,
+                    std::pair<value_type, typename list_type::iterator>>
+      map_value_type;
   typedef std::unordered_map<
-      key_type, std::pair<value_type, typename list_type::iterator>>
+      key_type, std::pair<value_type, typename list_type::iterator>, Hash,
+      KeyEqual, typename alloc_traits::template rebind_alloc<map_value_type>>
       map_type; //!< Hash map for fast lookups
 
   list_type m_list;
@@ -28,7 +47,12 @@ template <class Key, class Value> class lru_cache {
   }
 
 public:
-  explicit lru_cache(size_t n) : m_capacity(n) {}
+  typedef Allocator allocator_type;
+
+  explicit lru_cache(size_t n, const Allocator &alloc = Allocator())
+      : m_list(alloc), m_map(0, Hash(), KeyEqual(), alloc), m_capacity(n) {}
+
+  allocator_type get_allocator() const { return m_map.get_allocator(); }
 
   size_t size() const { return m_map.size(); }
 
@@ -70,3 +94,11 @@ public:
     }
   }
 };
+
+namespace pmr {
+template <class Key, class Value, class Hash = std::hash<Key>,
+          class KeyEqual = std::equal_to<Key>>
+using lru_cache =
+    ::lru_cache<Key, Value, Hash, KeyEqual,
+                std::pmr::polymorphic_allocator<std::pair<const Key, Value>>>;
+} // namespace pmr
@@ -0,0 +1,408 @@
+#pragma once
+
+#include "adjacency_list.h"
+#include "concurrent_union_find.h"
+#include "union_find.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Edge chosen for a spanning forest. Stored edges are treated as undirected.
+ */
+struct msf_edge {
+  size_t a;
+  size_t b;
+  int w;
+};
+
+/**
+ * Result of minimum_spanning_forest
+ */
+struct spanning_forest {
+  std::vector<msf_edge> edges; //!< One edge per merge, n - components total
+  long long weight = 0;        //!< Sum of the edge weights
+};
+
+enum class msf_algorithm {
+  boruvka,       //!< Parallel rounds of per-component cheapest edges
+  filter_kruskal //!< Kruskal that drops edges inside components before sorting
+};
+
+namespace detail {
+
+/**
+ * Strict total order on edges: by weight, then by endpoints. Ties between
+ * edges with equal keys are harmless, since such edges are interchangeable.
+ */
+inline bool msf_less(size_t a1, size_t b1, int w1, size_t a2, size_t b2,
+                     int w2) {
+  if (w1 != w2)
+    return w1 < w2;
+  const auto lo1 = std::min(a1, b1), lo2 = std::min(a2, b2);
+  if (lo1 != lo2)
+    return lo1 < lo2;
+  return std::max(a1, b1) < std::max(a2, b2);
+}
+
+inline bool msf_less(const msf_edge &x, const msf_edge &y) {
+  return msf_less(x.a, x.b, x.w, y.a, y.b, y.w);
+}
+
+/**
+ * Threads started once and reused by every parallel_for over them. The
+ * calling thread works as thread 0, so threads - 1 are started.
+ */
+class msf_workers {
+  std::vector<std::thread> pool_;
+  std::mutex m_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  std::function<void(size_t)> job_;
+  size_t generation_ = 0; //!< Bumped for each job
+  size_t pending_ = 0;    //!< Started threads still running the job
+  bool stop_ = false;
+
+  void work(size_t t) {
+    for (size_t seen = 0;;) {
+      {
+        std::unique_lock<std::mutex> lock(m_);
+        start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_)
+          return;
+        seen = generation_;
+      }
+      job_(t);
+      std::lock_guard<std::mutex> lock(m_);
+      if (--pending_ == 0)
+        done_.notify_one();
+    }
+  }
+
+public:
+  explicit msf_workers(size_t threads) {
+    for (size_t t = 1; t < threads; ++t)
+      pool_.emplace_back(&msf_workers::work, this, t);
+  }
+
+  msf_workers(const msf_workers &) = delete;
+  msf_workers &operator=(const msf_workers &) = delete;
+
+  ~msf_workers() {
+    {
+      std::lock_guard<std::mutex> lock(m_);
+      stop_ = true;
+    }
+    start_.notify_all();
+    for (auto &th : pool_)
+      th.join();
+  }
+
+  size_t size() const { return pool_.size() + 1; }
+
+  /**
+   * Run f(thread) on every thread and wait for all of them to finish.
+   */
+  template <class F> void run(F f) {
+    {
+      std::lock_guard<std::mutex> lock(m_);
+      job_ = [&f](size_t t) { f(t); };
+      pending_ = pool_.size();
+      ++generation_;
+    }
+    start_.notify_all();
+    f(size_t(0));
+    std::unique_lock<std::mutex> lock(m_);
+    done_.wait(lock, [&] { return pending_ == 0; });
+  }
+};
+
+/**
+ * Run f(lo, hi, thread) over contiguous slices of [0, n), one per thread.
+ */
+template <class F> void parallel_for(msf_workers &workers, size_t n, F f) {
+  const auto threads = workers.size();
+  if (threads <= 1 || n < 2 * threads) {
+    f(size_t(0), n, size_t(0));
+    return;
+  }
+  workers.run([&f, n, threads](size_t t) {
+    f(n * t / threads, n * (t + 1) / threads, t);
+  });
+}
+
+template <class EdgeType, class Allocator>
+spanning_forest boruvka(const adjacency_list<EdgeType, Allocator> &g,
+                        msf_workers &workers) {
+  const auto n = g.size();
+  const auto threads = workers.size();
+  const auto none = static_cast<size_t>(-1);
+
+  struct arc {
+    size_t d = static_cast<size_t>(-1);
+    int w = 0;
+  };
+
+  // Symmetric copy of the graph in compressed rows. A component has to see
+  // the edges stored at either end to find its cheapest one. Each row holds
+  // the stored edges of its vertex followed by the reversed ones.
+  //
+  // Reversed edges would land all over the rows, so they are first grouped
+  // by blocks of destinations, then placed one block at a time. Both passes
+  // write to a few cache-sized windows instead of the whole array.
+  const size_t block_bits = 12;
+  const auto blocks = (n >> block_bits) + 1;
+  std::vector<size_t> out(n);
+  std::vector<std::vector<size_t>> at(threads, std::vector<size_t>(blocks));
+  parallel_for(workers, n, [&](size_t lo, size_t hi, size_t t) {
+    for (auto v = lo; v < hi; ++v) {
+      for (const auto &e : g.neighbors(v)) {
+        if (e.get_dest() == v)
+          continue;
+        ++out[v];
+        ++at[t][e.get_dest() >> block_bits];
+      }
+    }
+  });
+  std::vector<size_t> block_first(blocks + 1, 0);
+  for (size_t b = 0, sum = 0; b < blocks; ++b) {
+    block_first[b] = sum;
+    for (auto &c : at) {
+      const auto k = c[b];
+      c[b] = sum;
+      sum += k;
+    }
+    block_first[b + 1] = sum;
+  }
+  std::vector<msf_edge> reversed(block_first[blocks]);
+  parallel_for(workers, n, [&](size_t lo, size_t hi, size_t t) {
+    for (auto v = lo; v < hi; ++v)
+      for (const auto &e : g.neighbors(v))
+        if (e.get_dest() != v)
+          reversed[at[t][e.get_dest() >> block_bits]++] = {
+              e.get_dest(), v, e.get_weight()};
+  });
+
+  std::vector<size_t> first(n + 1, 0); //!< Start of each row
+  for (size_t v = 0; v < n; ++v)
+    first[v + 1] = out[v];
+  parallel_for(workers, blocks, [&](size_t lo, size_t hi, size_t) {
+    for (auto i = block_first[lo]; i < block_first[hi]; ++i)
+      ++first[reversed[i].a + 1];
+  });
+  for (size_t v = 0; v < n; ++v)
+    first[v + 1] += first[v];
+
+  std::vector<arc> arcs(first[n]);
+  parallel_for(workers, n, [&](size_t lo, size_t hi, size_t) {
+    for (auto v = lo; v < hi; ++v) {
+      auto i = first[v];
+      for (const auto &e : g.neighbors(v))
+        if (e.get_dest() != v)
+          arcs[i++] = {e.get_dest(), e.get_weight()};
+    }
+  });
+  parallel_for(workers, blocks, [&](size_t lo, size_t hi, size_t) {
+    for (auto i = block_first[lo]; i < block_first[hi]; ++i) {
+      const auto &e = reversed[i];
+      arcs[first[e.a] + out[e.a]++] = {e.b, e.w};
+    }
+  });
+  reversed = std::vector<msf_edge>();
+
+  parallel_for(workers, n, [&](size_t lo, size_t hi, size_t) {
+    for (auto v = lo; v < hi; ++v)
+      std::sort(arcs.begin() + static_cast<std::ptrdiff_t>(first[v]),
+                arcs.begin() + static_cast<std::ptrdiff_t>(first[v + 1]),
+                [v](const arc &x, const arc &y) {
+                  return msf_less(v, x.d, x.w, v, y.d, y.w);
+                });
+  });
+
+  std::vector<arc> cand(n); //!< Cheapest edge leaving each vertex's component
+  std::vector<size_t> comp(n);
+  std::vector<std::atomic<size_t>> best(n); //!< Vertex holding the component
+                                            //!< minimum, or none
+  // First arc of each row that may still leave its component
+  std::vector<size_t> next(first.begin(), first.end() - 1);
+  std::vector<std::vector<msf_edge>> found(threads);
+  concurrent_union_find uf(n);
+
+  parallel_for(workers, n, [&](size_t lo, size_t hi, size_t) {
+    for (auto v = lo; v < hi; ++v)
+      best[v].store(none, std::memory_order_relaxed);
+  });
+
+  for (bool merged = true; merged;) {
+    parallel_for(workers, n, [&](size_t lo, size_t hi, size_t) {
+      for (auto v = lo; v < hi; ++v)
+        comp[v] = uf.root(v);
+    });
+
+    // Each vertex finds its own cheapest outgoing edge, then offers it to
+    // its component
+    parallel_for(workers, n, [&](size_t lo, size_t hi, size_t) {
+      for (auto v = lo; v < hi; ++v) {
+        // Arcs are sorted, so the first one leaving the component is the
+        // cheapest. Arcs inside the component stay inside, so skip them for
+        // good.
+        auto &i = next[v];
+        while (i < first[v + 1] && comp[arcs[i].d] == comp[v])
+          ++i;
+        if (i == first[v + 1])
+          continue;
+        const auto c = arcs[i];
+        cand[v] = c;
+        // Publish through the CAS so threads comparing against cand[v] see it
+        auto &slot = best[comp[v]];
+        auto cur = slot.load(std::memory_order_acquire);
+        while (cur == none || msf_less(v, c.d, c.w, cur, cand[cur].d,
+                                       cand[cur].w)) {
+          if (slot.compare_exchange_weak(cur, v, std::memory_order_acq_rel,
+                                         std::memory_order_acquire))
+            break;
+        }
+      }
+    });
+
+    // Contract along the chosen edges. The same edge may be chosen from both
+    // sides; only the first unite succeeds.
+    std::atomic<bool> any{false};
+    parallel_for(workers, n, [&](size_t lo, size_t hi, size_t t) {
+      bool local = false;
+      for (auto v = lo; v < hi; ++v) {
+        if (comp[v] != v)
+          continue;
+        const auto u = best[v].load(std::memory_order_relaxed);
+        if (u == none)
+          continue;
+        best[v].store(none, std::memory_order_relaxed);
+        if (uf.unite(u, cand[u].d)) {
+          found[t].push_back({u, cand[u].d, cand[u].w});
+          local = true;
+        }
+      }
+      if (local)
+        any = true;
+    });
+    merged = any;
+  }
+
+  spanning_forest f;
+  for (auto &part : found) {
+    for (const auto &e : part)
+      f.weight += e.w;
+    f.edges.insert(f.edges.end(), part.begin(), part.end());
+  }
+  return f;
+}
+
+/**
+ * Kruskal over edges already in order
+ */
+inline void kruskal(const msf_edge *first, const msf_edge *last,
+                    union_find &uf, spanning_forest &f) {
+  for (; first != last; ++first) {
+    if (uf.unite(first->a, first->b)) {
+      f.edges.push_back(*first);
+      f.weight += first->w;
+    }
+  }
+}
+
+inline void filter_kruskal(msf_edge *first, msf_edge *last, union_find &uf,
+                           spanning_forest &f, msf_workers &workers) {
+  const auto less = [](const msf_edge &x, const msf_edge &y) {
+    return msf_less(x, y);
+  };
+  if (last - first <= 4096) {
+    std::sort(first, last, less);
+    kruskal(first, last, uf, f);
+    return;
+  }
+
+  // Split around the median of three
+  msf_edge s[3] = {*first, first[(last - first) / 2], *(last - 1)};
+  std::sort(s, s + 3, less);
+  const auto pivot = s[1];
+  auto mid = std::partition(
+      first, last, [&](const msf_edge &e) { return less(e, pivot); });
+  if (mid == first) {
+    // Nothing below the pivot, so it is the minimum. Split off its equals.
+    mid = std::partition(
+        first, last, [&](const msf_edge &e) { return !less(pivot, e); });
+    kruskal(first, mid, uf, f);
+  } else {
+    filter_kruskal(first, mid, uf, f, workers);
+  }
+
+  // Drop heavier edges that now fall inside a single set. The const find
+  // does not compress paths, so slices can be filtered concurrently.
+  const auto n = static_cast<size_t>(last - mid);
+  std::vector<std::pair<size_t, size_t>> kept(workers.size()); //!< Start, size
+  const union_find &sets = uf;
+  parallel_for(workers, n, [&](size_t lo, size_t hi, size_t t) {
+    auto out = mid + lo;
+    for (auto e = mid + lo; e != mid + hi; ++e)
+      if (!sets.find(e->a, e->b))
+        *out++ = *e;
+    kept[t] = {lo, static_cast<size_t>(out - (mid + lo))};
+  });
+  // Slide the kept slices down together. The first one is already in place,
+  // and std::move may not target the start of its own source.
+  auto out = mid;
+  for (const auto &k : kept) {
+    const auto src = mid + k.first;
+    if (out == src)
+      out += k.second;
+    else
+      out = std::move(src, src + k.second, out);
+  }
+  filter_kruskal(mid, out, uf, f, workers);
+}
+
+} // namespace detail
+
+/**
+ * Compute a minimum spanning forest of a weighted graph. Every stored edge is
+ * treated as undirected, so graphs may store each edge once or in both
+ * directions. Self loops and parallel edges are allowed.
+ *
+ * @param  g         Graph to span
+ * @param  algorithm Borůvka runs every phase in parallel, including the
+ *                   symmetric copy of the graph it works on. Filter-Kruskal
+ *                   copies the edges once and only sorts those that can
+ *                   still join two sets.
+ * @param  threads   Number of threads, 0 for one per hardware thread
+ * @return           Chosen edges and their total weight
+ */
+template <class EdgeType, class Allocator>
+spanning_forest
+minimum_spanning_forest(const adjacency_list<EdgeType, Allocator> &g,
+                        msf_algorithm algorithm = msf_algorithm::boruvka,
+                        size_t threads = 0) {
+  if (threads == 0)
+    threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  detail::msf_workers workers(threads);
+  if (algorithm == msf_algorithm::boruvka)
+    return detail::boruvka(g, workers);
+
+  std::vector<msf_edge> edges;
+  for (size_t v = 0; v < g.size(); ++v)
+    for (const auto &e : g.neighbors(v))
+      if (e.get_dest() != v)
+        edges.push_back({v, e.get_dest(), e.get_weight()});
+
+  spanning_forest f;
+  union_find uf(g.size());
+  detail::filter_kruskal(edges.data(), edges.data() + edges.size(), uf, f,
+                         workers);
+  return f;
+}
@@ -0,0 +1,444 @@
+/**
+ * Radix sorts for integer, floating point and string keys.
+ *
+ * radix_sort is a least significant digit sort over 8-bit digits. It reads
+ * the keys once to build every digit histogram, skips the passes where all
+ * keys share the same digit, and then moves each element once per remaining
+ * pass through a buffer the size of the input. With more than one thread each
+ * thread histograms and scatters its own slice of the input. It is stable.
+ *
+ * american_flag_sort is an in-place most significant digit sort for when the
+ * buffer does not fit. It permutes each bucket into place by swapping, then
+ * recurses into the buckets. It is not stable.
+ *
+ * Keys are taken from the elements by a key extractor, so records can be
+ * sorted by one field. Arithmetic keys may be integers, float or double, but
+ * not long double. Signed integers and floating point keys are mapped to
+ * unsigned integers with the same order, which puts -0.0 before 0.0 and
+ * negative NaNs first and positive NaNs last. String keys are always sorted
+ * in place most significant digit first, in std::string order, so sorting by
+ * a string key is not stable.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace detail {
+
+struct radix_identity {
+  template <class T> const T &operator()(const T &x) const { return x; }
+};
+
+const std::size_t radix_insertion = 64; //!< Below this, insertion sort
+const std::size_t radix_grain = 1 << 16; //!< Fewest elements per thread
+const std::size_t radix_stage = 1 << 21; //!< Fewest elements to stage
+
+template <class K> struct radix_unsigned {
+  typedef typename std::make_unsigned<K>::type type;
+};
+template <> struct radix_unsigned<bool> {
+  typedef unsigned char type;
+};
+template <> struct radix_unsigned<float> {
+  typedef std::uint32_t type;
+};
+template <> struct radix_unsigned<double> {
+  typedef std::uint64_t type;
+};
+
+/**
+ * Map an arithmetic key to an unsigned integer with the same order.
+ */
+template <class K> typename radix_unsigned<K>::type radix_key(K k) {
+  typedef typename radix_unsigned<K>::type U;
+  const U sign = U(1) << (8 * sizeof(U) - 1);
+  if (std::is_floating_point<K>::value) {
+    U u;
+    std::memcpy(&u, &k, sizeof(u));
+    return u & sign ? U(~u) : U(u ^ sign);
+  }
+  if (std::is_signed<K>::value)
+    return static_cast<U>(static_cast<U>(k) ^ sign);
+  return static_cast<U>(k);
+}
+
+template <class KeyOf> struct radix_digit {
+  KeyOf &key;
+  unsigned shift;
+
+  template <class T> std::size_t operator()(const T &x) const {
+    return (radix_key(key(x)) >> shift) & 0xff;
+  }
+};
+
+template <class RandomIt, class Less>
+void insertion_sort(RandomIt first, RandomIt last, Less less) {
+  if (first == last)
+    return;
+  for (auto i = first + 1; i != last; ++i) {
+    auto v = std::move(*i);
+    auto j = i;
+    for (; j != first && less(v, *(j - 1)); --j)
+      *j = std::move(*(j - 1));
+    *j = std::move(v);
+  }
+}
+
+// Run f(t) for t in [0, threads), on the calling thread and threads - 1 more
+template <class F> void radix_threads(std::size_t threads, F f) {
+  std::vector<std::thread> pool;
+  for (std::size_t t = 1; t < threads; ++t)
+    pool.emplace_back(f, t);
+  f(0);
+  for (auto &th : pool)
+    th.join();
+}
+
+/**
+ * Move the elements of src[lo, hi) to their buckets in dst. When staging,
+ * small elements go through a cache line sized buffer per bucket and are
+ * written out a line at a time, so the 256 output streams cost fewer cache
+ * and TLB misses once the array is much larger than the cache.
+ */
+template <class Src, class Dst, class Digit>
+void radix_scatter(Src src, Dst dst, std::size_t lo, std::size_t hi,
+                   std::size_t *offset, Digit digit, bool staged) {
+  typedef typename std::iterator_traits<Src>::value_type T;
+  const std::size_t line = 64 / sizeof(T);
+  if (!staged || line < 4) {
+    for (auto i = lo; i < hi; ++i) {
+      const auto d = digit(src[i]);
+      dst[offset[d]++] = std::move(src[i]);
+    }
+    return;
+  }
+
+  std::vector<T> stage(256 * line);
+  std::size_t fill[256] = {};
+  for (auto i = lo; i < hi; ++i) {
+    const auto d = digit(src[i]);
+    const auto s = stage.begin() + d * line;
+    s[fill[d]] = std::move(src[i]);
+    if (++fill[d] == line) {
+      std::move(s, s + line, dst + offset[d]);
+      offset[d] += line;
+      fill[d] = 0;
+    }
+  }
+  for (std::size_t d = 0; d < 256; ++d) {
+    const auto s = stage.begin() + d * line;
+    std::move(s, s + fill[d], dst + offset[d]);
+    offset[d] += fill[d];
+  }
+}
+
+template <class RandomIt, class KeyOf>
+void lsd_sort(RandomIt first, RandomIt last, KeyOf &key, std::size_t threads,
+              std::true_type) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  typedef decltype(radix_key(key(*first))) U;
+  typedef std::array<std::size_t, 256> histogram;
+  const std::size_t passes = sizeof(U);
+  const std::size_t n = last - first;
+
+  const auto less = [&](const T &a, const T &b) {
+    return radix_key(key(a)) < radix_key(key(b));
+  };
+  if (n < radix_insertion) {
+    insertion_sort(first, last, less);
+    return;
+  }
+  threads = std::max<std::size_t>(std::min(threads, n / radix_grain), 1);
+  const auto lo = [&](std::size_t t) { return n * t / threads; };
+
+  // Every digit of every slice in one read
+  std::vector<histogram> counts(threads * passes, histogram());
+  radix_threads(threads, [&](std::size_t t) {
+    const auto c = &counts[t * passes];
+    for (auto i = lo(t); i < lo(t + 1); ++i) {
+      const auto k = radix_key(key(first[i]));
+      for (std::size_t p = 0; p < passes; ++p)
+        ++c[p][(k >> (8 * p)) & 0xff];
+    }
+  });
+
+  // A pass is trivial if every key has the same digit
+  std::vector<std::size_t> active;
+  for (std::size_t p = 0; p < passes; ++p) {
+    histogram total{};
+    for (std::size_t t = 0; t < threads; ++t)
+      for (std::size_t b = 0; b < 256; ++b)
+        total[b] += counts[t * passes + p][b];
+    if (std::find(total.begin(), total.end(), n) == total.end())
+      active.push_back(p);
+  }
+  if (active.empty())
+    return;
+
+  std::vector<T> buf(n);
+  std::vector<histogram> offset(threads);
+  const bool staged = n >= radix_stage;
+  for (std::size_t i = 0; i < active.size(); ++i) {
+    const auto p = active[i];
+    const radix_digit<KeyOf> digit{key, static_cast<unsigned>(8 * p)};
+    const bool to_buf = i % 2 == 0;
+
+    // Slices have moved since the first count, so recount them
+    if (i > 0 && threads > 1) {
+      radix_threads(threads, [&](std::size_t t) {
+        auto &c = counts[t * passes + p];
+        c.fill(0);
+        for (auto j = lo(t); j < lo(t + 1); ++j)
+          ++c[to_buf ? digit(first[j]) : digit(buf[j])];
+      });
+    }
+
+    // Each thread writes its part of each bucket after the threads before it
+    std::size_t sum = 0;
+    for (std::size_t b = 0; b < 256; ++b) {
+      for (std::size_t t = 0; t < threads; ++t) {
+        offset[t][b] = sum;
+        sum += counts[t * passes + p][b];
+      }
+    }
+
+    radix_threads(threads, [&](std::size_t t) {
+      if (to_buf)
+        radix_scatter(first, buf.begin(), lo(t), lo(t + 1), offset[t].data(),
+                      digit, staged);
+      else
+        radix_scatter(buf.begin(), first, lo(t), lo(t + 1), offset[t].data(),
+                      digit, staged);
+    });
+  }
+
+  if (active.size() % 2) {
+    radix_threads(threads, [&](std::size_t t) {
+      std::move(buf.begin() + lo(t), buf.begin() + lo(t + 1), first + lo(t));
+    });
+  }
+}
+
+template <class RandomIt, class KeyOf>
+void flag_sort(RandomIt first, RandomIt last, KeyOf &key, unsigned shift) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  const auto less = [&](const T &a, const T &b) {
+    return radix_key(key(a)) < radix_key(key(b));
+  };
+
+  for (;;) {
+    const std::size_t n = last - first;
+    if (n < radix_insertion) {
+      insertion_sort(first, last, less);
+      return;
+    }
+
+    const radix_digit<KeyOf> digit{key, shift};
+    std::size_t count[256] = {};
+    for (auto i = first; i != last; ++i)
+      ++count[digit(*i)];
+    if (std::find(count, count + 256, n) != count + 256) {
+      // Every key has the same digit
+      if (shift == 0)
+        return;
+      shift -= 8;
+      continue;
+    }
+
+    std::size_t head[256];
+    std::size_t tail[256];
+    for (std::size_t b = 0, sum = 0; b < 256; ++b) {
+      head[b] = sum;
+      sum += count[b];
+      tail[b] = sum;
+    }
+
+    // Swap each element into its bucket until every bucket is full
+    for (std::size_t b = 0; b < 256; ++b) {
+      while (head[b] < tail[b]) {
+        auto v = std::move(first[head[b]]);
+        for (auto d = digit(v); d != b; d = digit(v))
+          std::swap(v, first[head[d]++]);
+        first[head[b]++] = std::move(v);
+      }
+    }
+
+    if (shift == 0)
+      return;
+    for (std::size_t b = 0; b < 256; ++b)
+      if (count[b] > 1)
+        flag_sort(first + (tail[b] - count[b]), first + tail[b], key,
+                  shift - 8);
+    return;
+  }
+}
+
+/**
+ * Compare two strings from a position both are known to share up to.
+ */
+template <class S>
+bool string_less(const S &a, const S &b, std::size_t depth) {
+  const std::size_t n = std::min(a.size(), b.size());
+  for (auto i = depth; i < n; ++i)
+    if (a[i] != b[i])
+      return static_cast<unsigned char>(a[i]) <
+             static_cast<unsigned char>(b[i]);
+  return a.size() < b.size();
+}
+
+/**
+ * Sort by string keys, most significant digit first. Buckets still to sort
+ * are kept on an explicit stack rather than recursed into, since keys nested
+ * as prefixes of each other would otherwise take one frame per character.
+ */
+template <class RandomIt, class KeyOf>
+void string_flag_sort(RandomIt first, RandomIt last, KeyOf &key) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  struct range {
+    std::size_t lo, hi; //!< Offsets from first
+    std::size_t depth;  //!< Length of the prefix all keys share
+  };
+
+  std::vector<range> todo{{0, static_cast<std::size_t>(last - first), 0}};
+  while (!todo.empty()) {
+    const auto r = todo.back();
+    todo.pop_back();
+    const auto lo = first + r.lo;
+    const auto n = r.hi - r.lo;
+    const auto depth = r.depth;
+    if (n < radix_insertion) {
+      insertion_sort(lo, lo + n, [&](const T &a, const T &b) {
+        return string_less(key(a), key(b), depth);
+      });
+      continue;
+    }
+
+    // Bucket 0 holds the keys that end here
+    const auto digit = [&](const T &x) -> std::size_t {
+      const auto &k = key(x);
+      return depth < k.size() ? 1 + static_cast<unsigned char>(k[depth]) : 0;
+    };
+    std::size_t count[257] = {};
+    for (auto i = lo; i != lo + n; ++i)
+      ++count[digit(*i)];
+    if (count[0] == n)
+      continue;
+    if (std::find(count + 1, count + 257, n) != count + 257) {
+      todo.push_back({r.lo, r.hi, depth + 1});
+      continue;
+    }
+
+    std::size_t head[257];
+    std::size_t tail[257];
+    for (std::size_t b = 0, sum = 0; b < 257; ++b) {
+      head[b] = sum;
+      sum += count[b];
+      tail[b] = sum;
+    }
+
+    for (std::size_t b = 0; b < 257; ++b) {
+      while (head[b] < tail[b]) {
+        auto v = std::move(lo[head[b]]);
+        for (auto d = digit(v); d != b; d = digit(v))
+          std::swap(v, lo[head[d]++]);
+        lo[head[b]++] = std::move(v);
+      }
+    }
+
+    for (std::size_t b = 1; b < 257; ++b)
+      if (count[b] > 1)
+        todo.push_back({r.lo + tail[b] - count[b], r.lo + tail[b], depth + 1});
+  }
+}
+
+// String keys are sorted most significant digit first
+template <class RandomIt, class KeyOf>
+void lsd_sort(RandomIt first, RandomIt last, KeyOf &key, std::size_t,
+              std::false_type) {
+  string_flag_sort(first, last, key);
+}
+
+template <class RandomIt, class KeyOf>
+void flag_sort(RandomIt first, RandomIt last, KeyOf &key, std::true_type) {
+  typedef decltype(radix_key(key(*first))) U;
+  flag_sort(first, last, key, static_cast<unsigned>(8 * (sizeof(U) - 1)));
+}
+
+template <class RandomIt, class KeyOf>
+void flag_sort(RandomIt first, RandomIt last, KeyOf &key, std::false_type) {
+  string_flag_sort(first, last, key);
+}
+
+template <class RandomIt, class KeyOf>
+using radix_key_type = typename std::decay<decltype(
+    std::declval<KeyOf &>()(*std::declval<RandomIt>()))>::type;
+
+template <class RandomIt, class KeyOf>
+using radix_is_arithmetic =
+    std::is_arithmetic<radix_key_type<RandomIt, KeyOf>>;
+
+/**
+ * Reject keys that are arithmetic but have no unsigned mapping.
+ */
+template <class RandomIt, class KeyOf> constexpr bool radix_check_key() {
+  static_assert(!std::is_same<radix_key_type<RandomIt, KeyOf>,
+                              long double>::value,
+                "radix_sort: long double keys are not supported, only "
+                "integers, float and double");
+  return true;
+}
+
+} // namespace detail
+
+/**
+ * Least significant digit radix sort, stable for arithmetic keys.
+ * @param first   Start of the range to sort
+ * @param last    End of the range to sort
+ * @param key     Returns the key of an element: an arithmetic type, or a
+ *                string with size() and operator[]
+ * @param threads Number of threads, 0 for one per hardware thread. Only used
+ *                for arithmetic keys, and at most one per 64K elements.
+ */
+template <class RandomIt, class KeyOf = detail::radix_identity>
+void radix_sort(RandomIt first, RandomIt last, KeyOf key = KeyOf(),
+                std::size_t threads = 1) {
+  static_assert(detail::radix_check_key<RandomIt, KeyOf>(), "");
+  if (threads == 0)
+    threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  detail::lsd_sort(first, last, key, threads,
+                   detail::radix_is_arithmetic<RandomIt, KeyOf>());
+}
+
+template <class T, class KeyOf = detail::radix_identity>
+void radix_sort(std::vector<T> &v, KeyOf key = KeyOf(),
+                std::size_t threads = 1) {
+  radix_sort(v.begin(), v.end(), key, threads);
+}
+
+/**
+ * In-place most significant digit radix sort, using no memory beyond the
+ * histograms on the stack. Not stable.
+ * @param first Start of the range to sort
+ * @param last  End of the range to sort
+ * @param key   Returns the key of an element, as for radix_sort
+ */
+template <class RandomIt, class KeyOf = detail::radix_identity>
+void american_flag_sort(RandomIt first, RandomIt last, KeyOf key = KeyOf()) {
+  static_assert(detail::radix_check_key<RandomIt, KeyOf>(), "");
+  detail::flag_sort(first, last, key,
+                    detail::radix_is_arithmetic<RandomIt, KeyOf>());
+}
+
+template <class T, class KeyOf = detail::radix_identity>
+void american_flag_sort(std::vector<T> &v, KeyOf key = KeyOf()) {
+  american_flag_sort(v.begin(), v.end(), key);
+}
@@ -0,0 +1,528 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * Adaptive Radix Tree mapping strings to values.
+ *
+ * Path compressed version of trie. Chains of single-child nodes are collapsed
+ * into one node holding the whole edge label, and every node is sized for the
+ * number of children it actually has (0, 4, 16, 48 or 256) so sparse nodes
+ * stay small while dense nodes get direct indexing.
+ *
+ * Value must be default constructible.
+ */
+template <class Value> class radix_tree {
+  typedef std::size_t size_t;
+  typedef std::uint8_t byte;
+
+  enum class node_type : byte { n0, n4, n16, n48, n256 };
+
+  struct node;
+  struct node_deleter {
+    void operator()(node *n) const noexcept;
+  };
+  typedef std::unique_ptr<node, node_deleter> node_ptr;
+
+  /**
+   * Common node header. Used directly for leaves without children.
+   */
+  struct node {
+    std::string prefix;      //!< Edge label following the parent's branch byte
+    Value value = Value();   //!< Associated value, valid if leaf is set
+    std::uint16_t count = 0; //!< Number of children
+    node_type type;
+    bool leaf = false; //!< True if a key ends at this node
+
+    explicit node(node_type t) : type(t) {}
+  };
+
+  struct node4 : node {
+    byte keys[4]; //!< Sorted branch bytes
+    node_ptr child[4];
+    node4() : node(node_type::n4) {}
+  };
+
+  struct node16 : node {
+    byte keys[16]; //!< Sorted branch bytes
+    node_ptr child[16];
+    node16() : node(node_type::n16) {}
+  };
+
+  struct node48 : node {
+    byte index[256] = {}; //!< Slot + 1 of the child for each byte, 0 if none
+    node_ptr child[48];
+    node48() : node(node_type::n48) {}
+  };
+
+  struct node256 : node {
+    node_ptr child[256];
+    node256() : node(node_type::n256) {}
+  };
+
+  node_ptr root_{new node(node_type::n0)};
+  size_t size_ = 0;
+
+  static size_t capacity(const node *n) {
+    switch (n->type) {
+    case node_type::n0:
+      return 0;
+    case node_type::n4:
+      return 4;
+    case node_type::n16:
+      return 16;
+    case node_type::n48:
+      return 48;
+    default:
+      return 256;
+    }
+  }
+
+  /**
+   * Find the child slot for a branch byte.
+   * @param  n Node to search
+   * @param  b Branch byte
+   * @return   Pointer to the child slot, or nullptr if there is no child
+   */
+  static node_ptr *find_child(node *n, byte b) {
+    switch (n->type) {
+    case node_type::n0:
+      return nullptr;
+    case node_type::n4: {
+      const auto p = static_cast<node4 *>(n);
+      for (size_t i = 0; i < p->count; ++i)
+        if (p->keys[i] == b)
+          return &p->child[i];
+      return nullptr;
+    }
+    case node_type::n16: {
+      const auto p = static_cast<node16 *>(n);
+#ifdef __SSE2__
+      const auto keys =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(p->keys));
+      const auto cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(b)), keys);
+      const auto mask = _mm_movemask_epi8(cmp) & ((1 << p->count) - 1);
+      if (mask)
+        return &p->child[__builtin_ctz(static_cast<unsigned>(mask))];
+#else
+      for (size_t i = 0; i < p->count; ++i)
+        if (p->keys[i] == b)
+          return &p->child[i];
+#endif
+      return nullptr;
+    }
+    case node_type::n48: {
+      const auto p = static_cast<node48 *>(n);
+      return p->index[b] ? &p->child[p->index[b] - 1] : nullptr;
+    }
+    default: {
+      const auto p = static_cast<node256 *>(n);
+      return p->child[b] ? &p->child[b] : nullptr;
+    }
+    }
+  }
+
+  /**
+   * Move the header and children of one node into a node of another size.
+   * The destination must have room for every child.
+   */
+  template <class From, class To> static void move_sorted(From *f, To *t) {
+    for (size_t i = 0; i < f->count; ++i) {
+      t->keys[i] = f->keys[i];
+      t->child[i] = std::move(f->child[i]);
+    }
+  }
+
+  static void move_header(node *f, node *t) {
+    t->prefix = std::move(f->prefix);
+    t->value = std::move(f->value);
+    t->count = f->count;
+    t->leaf = f->leaf;
+  }
+
+  /**
+   * Replace a node with the next larger node type.
+   * @param ref Slot holding the node
+   */
+  static void grow(node_ptr &ref) {
+    node *n = ref.get();
+    node_ptr g;
+    switch (n->type) {
+    case node_type::n0:
+      g.reset(new node4);
+      break;
+    case node_type::n4: {
+      const auto p = new node16;
+      g.reset(p);
+      move_sorted(static_cast<node4 *>(n), p);
+      break;
+    }
+    case node_type::n16: {
+      const auto f = static_cast<node16 *>(n);
+      const auto p = new node48;
+      g.reset(p);
+      for (size_t i = 0; i < f->count; ++i) {
+        p->index[f->keys[i]] = static_cast<byte>(i + 1);
+        p->child[i] = std::move(f->child[i]);
+      }
+      break;
+    }
+    default: {
+      const auto f = static_cast<node48 *>(n);
+      const auto p = new node256;
+      g.reset(p);
+      for (size_t b = 0; b < 256; ++b)
+        if (f->index[b])
+          p->child[b] = std::move(f->child[f->index[b] - 1]);
+      break;
+    }
+    }
+    move_header(n, g.get());
+    ref = std::move(g);
+  }
+
+  /**
+   * Replace a node with the next smaller node type. The node must have few
+   * enough children to fit.
+   * @param ref Slot holding the node
+   */
+  static void shrink(node_ptr &ref) {
+    node *n = ref.get();
+    node_ptr s;
+    switch (n->type) {
+    case node_type::n4:
+      s.reset(new node(node_type::n0));
+      break;
+    case node_type::n16: {
+      const auto p = new node4;
+      s.reset(p);
+      move_sorted(static_cast<node16 *>(n), p);
+      break;
+    }
+    case node_type::n48: {
+      const auto f = static_cast<node48 *>(n);
+      const auto p = new node16;
+      s.reset(p);
+      size_t i = 0;
+      for (size_t b = 0; b < 256; ++b) {
+        if (f->index[b]) {
+          p->keys[i] = static_cast<byte>(b);
+          p->child[i++] = std::move(f->child[f->index[b] - 1]);
+        }
+      }
+      break;
+    }
+    default: {
+      const auto f = static_cast<node256 *>(n);
+      const auto p = new node48;
+      s.reset(p);
+      size_t i = 0;
+      for (size_t b = 0; b < 256; ++b) {
+        if (f->child[b]) {
+          p->index[b] = static_cast<byte>(i + 1);
+          p->child[i++] = std::move(f->child[b]);
+        }
+      }
+      break;
+    }
+    }
+    move_header(n, s.get());
+    ref = std::move(s);
+  }
+
+  template <class N> static void insert_sorted(N *n, byte b, node_ptr c) {
+    size_t i = n->count;
+    for (; i > 0 && n->keys[i - 1] > b; --i) {
+      n->keys[i] = n->keys[i - 1];
+      n->child[i] = std::move(n->child[i - 1]);
+    }
+    n->keys[i] = b;
+    n->child[i] = std::move(c);
+  }
+
+  template <class N> static void erase_sorted(N *n, byte b) {
+    size_t i = 0;
+    while (n->keys[i] != b)
+      ++i;
+    for (; i + 1 < n->count; ++i) {
+      n->keys[i] = n->keys[i + 1];
+      n->child[i] = std::move(n->child[i + 1]);
+    }
+    n->child[i].reset();
+  }
+
+  /**
+   * Add a child under a new branch byte, growing the node if it is full.
+   * @param ref Slot holding the parent node
+   * @param b   Branch byte, must not already be present
+   * @param c   Child to add
+   */
+  static void add_child(node_ptr &ref, byte b, node_ptr c) {
+    if (ref->count == capacity(ref.get()))
+      grow(ref);
+    node *n = ref.get();
+    switch (n->type) {
+    case node_type::n4:
+      insert_sorted(static_cast<node4 *>(n), b, std::move(c));
+      break;
+    case node_type::n16:
+      insert_sorted(static_cast<node16 *>(n), b, std::move(c));
+      break;
+    case node_type::n48: {
+      const auto p = static_cast<node48 *>(n);
+      size_t i = 0;
+      while (p->child[i])
+        ++i;
+      p->index[b] = static_cast<byte>(i + 1);
+      p->child[i] = std::move(c);
+      break;
+    }
+    default:
+      static_cast<node256 *>(n)->child[b] = std::move(c);
+      break;
+    }
+    ++n->count;
+  }
+
+  /**
+   * Remove the child under a branch byte, shrinking the node once it is
+   * sparse enough.
+   * @param ref Slot holding the parent node
+   * @param b   Branch byte, must be present
+   */
+  static void remove_child(node_ptr &ref, byte b) {
+    node *n = ref.get();
+    size_t low = 0;
+    switch (n->type) {
+    case node_type::n4:
+      erase_sorted(static_cast<node4 *>(n), b);
+      break;
+    case node_type::n16:
+      erase_sorted(static_cast<node16 *>(n), b);
+      low = 3;
+      break;
+    case node_type::n48: {
+      const auto p = static_cast<node48 *>(n);
+      p->child[p->index[b] - 1].reset();
+      p->index[b] = 0;
+      low = 12;
+      break;
+    }
+    default:
+      static_cast<node256 *>(n)->child[b].reset();
+      low = 40;
+      break;
+    }
+    if (--n->count == low)
+      shrink(ref);
+  }
+
+  /**
+   * Collapse a valueless node with a single child into that child.
+   * @param ref Slot holding the node
+   */
+  static void merge(node_ptr &ref) {
+    node *n = ref.get();
+    byte b = 0;
+    node_ptr *c = nullptr;
+    for (size_t i = 0; !c; ++i) {
+      b = static_cast<byte>(i);
+      c = find_child(n, b);
+    }
+    node_ptr only = std::move(*c);
+    only->prefix.insert(0, 1, static_cast<char>(b));
+    only->prefix.insert(0, n->prefix);
+    ref = std::move(only);
+  }
+
+  static node_ptr make_leaf(const std::string &s, size_t i, Value v) {
+    node_ptr n(new node(node_type::n0));
+    n->prefix.assign(s, i, std::string::npos);
+    n->value = std::move(v);
+    n->leaf = true;
+    return n;
+  }
+
+  /**
+   * Find the node where a key ends.
+   * @param  s Key to search for
+   * @return   Node holding the key, or nullptr if the key is not present
+   */
+  node *find_node(const std::string &s) const {
+    node *n = root_.get();
+    size_t depth = 0;
+    while (n) {
+      if (s.compare(depth, n->prefix.size(), n->prefix) != 0)
+        return nullptr;
+      depth += n->prefix.size();
+      if (depth == s.size())
+        return n->leaf ? n : nullptr;
+      const auto c = find_child(n, static_cast<byte>(s[depth++]));
+      n = c ? c->get() : nullptr;
+    }
+    return nullptr;
+  }
+
+  /**
+   * Recursively erase a key, collapsing nodes left behind on the way back up.
+   * @param ref   Slot holding the current traversal node.
+   * @param s     Key to erase.
+   * @param depth Number of key bytes consumed above this node.
+   * @return      True if the key was found and erased.
+   */
+  bool erase(node_ptr &ref, const std::string &s, size_t depth) {
+    node *n = ref.get();
+    if (s.compare(depth, n->prefix.size(), n->prefix) != 0)
+      return false;
+    depth += n->prefix.size();
+    if (depth == s.size()) {
+      if (!n->leaf)
+        return false;
+      n->leaf = false;
+      n->value = Value();
+      --size_;
+      return true;
+    }
+    const auto b = static_cast<byte>(s[depth]);
+    const auto c = find_child(n, b);
+    if (!c || !erase(*c, s, depth + 1))
+      return false;
+    if (!(*c)->leaf) {
+      if ((*c)->count == 0)
+        remove_child(ref, b);
+      else if ((*c)->count == 1)
+        merge(*c);
+    }
+    return true;
+  }
+
+public:
+  typedef std::string key_type;
+  typedef Value mapped_type;
+
+  /**
+   * Insert a key, or overwrite the value of an existing key.
+   * @param  s Key to insert
+   * @param  v Value to associate with the key
+   * @return   True if the key was not already present
+   */
+  bool insert(const std::string &s, Value v = Value()) {
+    if (!root_)
+      root_.reset(new node(node_type::n0));
+    node_ptr *ref = &root_;
+    size_t depth = 0;
+    while (true) {
+      node *n = ref->get();
+      const auto &prefix = n->prefix;
+      size_t p = 0;
+      while (p < prefix.size() && depth + p < s.size() &&
+             prefix[p] == s[depth + p])
+        ++p;
+
+      if (p < prefix.size()) {
+        // Split the edge label where the key diverges
+        node_ptr split(new node4);
+        split->prefix.assign(prefix, 0, p);
+        const auto b = static_cast<byte>(prefix[p]);
+        n->prefix.erase(0, p + 1);
+        add_child(split, b, std::move(*ref));
+        *ref = std::move(split);
+        depth += p;
+        if (depth == s.size()) {
+          (*ref)->leaf = true;
+          (*ref)->value = std::move(v);
+        } else {
+          const auto nb = static_cast<byte>(s[depth]);
+          add_child(*ref, nb, make_leaf(s, depth + 1, std::move(v)));
+        }
+        ++size_;
+        return true;
+      }
+
+      depth += p;
+      if (depth == s.size()) {
+        n->value = std::move(v);
+        if (n->leaf)
+          return false;
+        n->leaf = true;
+        ++size_;
+        return true;
+      }
+
+      const auto b = static_cast<byte>(s[depth]);
+      const auto c = find_child(n, b);
+      if (!c) {
+        add_child(*ref, b, make_leaf(s, depth + 1, std::move(v)));
+        ++size_;
+        return true;
+      }
+      ref = c;
+      ++depth;
+    }
+  }
+
+  /**
+   * Look up the value associated with a key.
+   * @param  s Key to search for
+   * @return   Pointer to the value, or nullptr if the key is not present
+   */
+  Value *find(const std::string &s) {
+    const auto n = find_node(s);
+    return n ? &n->value : nullptr;
+  }
+
+  const Value *find(const std::string &s) const {
+    const auto n = find_node(s);
+    return n ? &n->value : nullptr;
+  }
+
+  /**
+   * Test if a key is present in the container.
+   * @param  s Key to test
+   * @return   Returns true if found
+   */
+  bool contains(const std::string &s) const { return find_node(s) != nullptr; }
+
+  /**
+   * Remove a key from the tree.
+   * @param  s Key to remove
+   * @return   True if the key was present
+   */
+  bool erase(const std::string &s) { return root_ && erase(root_, s, 0); }
+
+  size_t size() const noexcept { return size_; }
+
+  bool empty() const noexcept { return size_ == 0; }
+
+  void clear() {
+    root_.reset(new node(node_type::n0));
+    size_ = 0;
+  }
+};
+
+template <class Value>
+void radix_tree<Value>::node_deleter::operator()(node *n) const noexcept {
+  switch (n->type) {
+  case node_type::n0:
+    delete n;
+    break;
+  case node_type::n4:
+    delete static_cast<node4 *>(n);
+    break;
+  case node_type::n16:
+    delete static_cast<node16 *>(n);
+    break;
+  case node_type::n48:
+    delete static_cast<node48 *>(n);
+    break;
+  case node_type::n256:
+    delete static_cast<node256 *>(n);
+    break;
+  }
+}
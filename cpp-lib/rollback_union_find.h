@@ -0,0 +1,126 @@
+#pragma once
+
+#include "union_find.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * Union Find data structure with undo
+ *
+ * Weighted Quick Union Find without path compression, so every unite only
+ * changes two entries and can be reverted exactly. Trees stay at most logN
+ * high from union by size alone, so root() is O(logN).
+ *
+ * Uses the same packed layout as union_find: a root stores the negated size
+ * of its set, every other element stores its parent. It has the same limit
+ * of 2^31 - 1 elements; constructing a bigger one throws std::length_error.
+ */
+class rollback_union_find {
+  typedef std::size_t size_t;
+
+  struct change {
+    std::int32_t child; //!< Root that was hung under another root
+    std::int32_t size;  //!< Its entry before the unite, -size of its set
+  };
+
+  std::vector<std::int32_t> v; //!< Parent, or -size for roots
+  std::vector<change> log;     //!< Successful unites, oldest first
+  size_t sets = 0;             //!< Number of disjoint sets
+
+public:
+  explicit rollback_union_find(size_t n)
+      : v(detail::check_packed_forest_size(n, "rollback_union_find"), -1),
+        sets(n) {}
+
+  /**
+   * Get the largest number of elements the structure can hold.
+   */
+  static constexpr size_t max_size() noexcept {
+    return detail::packed_forest_max_size();
+  }
+
+  /**
+   * Find root of set for the given element.
+   * @param  a Element to search for
+   * @return   Root ID associated with input Element
+   */
+  size_t root(size_t a) const {
+    while (v[a] >= 0)
+      a = static_cast<size_t>(v[a]);
+    return a;
+  }
+
+  /**
+   * Connect two elements. Connects the smaller tree under the bigger for a max
+   * height of logN.
+   * @param  a Element 1
+   * @param  b Element 2
+   * @return   True if the elements were in different sets
+   */
+  bool unite(size_t a, size_t b) {
+    auto rootA = root(a);
+    auto rootB = root(b);
+    if (rootA == rootB)
+      return false;
+    if (v[rootA] > v[rootB])
+      std::swap(rootA, rootB);
+    // rootA is now the bigger tree
+    log.push_back({static_cast<std::int32_t>(rootB), v[rootB]});
+    v[rootA] += v[rootB];
+    v[rootB] = static_cast<std::int32_t>(rootA);
+    --sets;
+    return true;
+  }
+
+  /**
+   * Check if two elements are in the same set
+   * @param  a Element 1
+   * @param  b Element 2
+   * @return   True if elements are connected
+   */
+  bool find(size_t a, size_t b) const { return root(a) == root(b); }
+
+  /**
+   * Mark the current state so it can be restored later.
+   * @return Token to pass to rollback
+   */
+  size_t checkpoint() const noexcept { return log.size(); }
+
+  /**
+   * Undo every successful unite made since a checkpoint, in O(1) each.
+   * @param to Value returned by checkpoint
+   */
+  void rollback(size_t to) {
+    while (log.size() > to) {
+      const auto c = log.back();
+      log.pop_back();
+      const auto child = static_cast<size_t>(c.child);
+      v[static_cast<size_t>(v[child])] -= c.size;
+      v[child] = c.size;
+      ++sets;
+    }
+  }
+
+  /**
+   * Get size of the set containing an element.
+   * @param  a Element
+   * @return   Number of elements in the set
+   */
+  size_t set_size(size_t a) const {
+    return static_cast<size_t>(-static_cast<std::int64_t>(v[root(a)]));
+  }
+
+  /**
+   * Get number of disjoint sets.
+   * @return Number of sets
+   */
+  size_t num_sets() const noexcept { return sets; }
+
+  /**
+   * Get number of elements.
+   * @return Number of elements in data structure
+   */
+  size_t size() const noexcept { return v.size(); }
+};
@@ -0,0 +1,604 @@
+#pragma once
+
+#include "trie.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Immutable, succinct version of trie.
+ *
+ * Nodes are numbered in breadth-first order and the shape of the tree is
+ * stored as a LOUDS (level-order unary degree sequence) bitvector: each node
+ * writes a 1 per child followed by a 0. Together with one label byte and one
+ * terminal bit per node that is about 1.5 bytes per node, with no pointers.
+ *
+ * The representation is a single flat buffer, so it can be written to a file
+ * with save() and queried straight out of an mmap with open(), without any
+ * deserialization.
+ *
+ * File layout, all sections 8 byte aligned and in native byte order:
+ *   header                    magic, node count, key count
+ *   LOUDS bits                2 * nodes + 1 bits
+ *   LOUDS rank directory      ones before each 512 bit block
+ *   LOUDS select samples      block holding every 1024th zero
+ *   terminal bits             1 bit per node
+ *   terminal rank directory   ones before each 512 bit block
+ *   labels                    1 byte per node, root unused
+ */
+class static_trie {
+  typedef std::size_t size_t;
+  typedef std::uint64_t word;
+
+  static constexpr word magic = 0x3145495254435453; // "STCTRIE1"
+  static constexpr size_t block_words = 8;          // 512 bit rank blocks
+  static constexpr size_t sample_rate = 1024;       // zeros per select sample
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  struct header {
+    word magic;
+    word nodes;
+    word keys;
+  };
+
+  /**
+   * Read-only view of a bitvector with a rank directory.
+   */
+  struct bitvector {
+    const word *bits = nullptr;
+    const word *ranks = nullptr; //!< Ones before each block, plus total
+    size_t size = 0;
+
+    bool get(size_t i) const { return (bits[i / 64] >> (i % 64)) & 1; }
+
+    /**
+     * Count ones before a position.
+     * @param  i Position
+     * @return   Number of ones in [0, i)
+     */
+    size_t rank1(size_t i) const {
+      const auto w = i / 64;
+      size_t r = ranks[w / block_words];
+      for (auto j = w - w % block_words; j < w; ++j)
+        r += static_cast<size_t>(__builtin_popcountll(bits[j]));
+      if (i % 64)
+        r += static_cast<size_t>(
+            __builtin_popcountll(bits[w] & ((word(1) << (i % 64)) - 1)));
+      return r;
+    }
+  };
+
+  // Sizes of each section, in words
+  static size_t bit_words(size_t bits) { return (bits + 63) / 64; }
+  static size_t rank_words(size_t bits) {
+    return (bit_words(bits) + block_words - 1) / block_words + 1;
+  }
+  static size_t sample_words(size_t zeros) {
+    return (zeros + sample_rate - 1) / sample_rate;
+  }
+
+  static size_t total_words(size_t nodes) {
+    const auto louds = 2 * nodes + 1;
+    return sizeof(header) / sizeof(word) + bit_words(louds) +
+           rank_words(louds) + sample_words(nodes + 1) + bit_words(nodes) +
+           rank_words(nodes) + (nodes + 7) / 8;
+  }
+
+  std::vector<word> buf_; //!< Owned storage when not memory mapped
+  void *map_ = nullptr;   //!< Memory mapped file, if any
+  size_t map_size_ = 0;
+
+  size_t nodes_ = 0;
+  size_t keys_ = 0;
+  bitvector louds_;
+  const word *samples_ = nullptr;
+  bitvector terminal_;
+  const unsigned char *labels_ = nullptr;
+
+  /**
+   * Point every section at a serialized buffer.
+   * @param base  Start of the buffer
+   * @param words Size of the buffer
+   */
+  void attach(const word *base, size_t words) {
+    if (words < sizeof(header) / sizeof(word))
+      throw std::runtime_error("static_trie: truncated data");
+    const auto h = reinterpret_cast<const header *>(base);
+    // Bound the node count first so total_words cannot overflow
+    if (h->magic != magic || h->nodes == 0 || h->nodes > words * 64 / 2 ||
+        words != total_words(h->nodes))
+      throw std::runtime_error("static_trie: invalid data");
+    nodes_ = h->nodes;
+    keys_ = h->keys;
+    const auto louds = 2 * nodes_ + 1;
+
+    auto p = base + sizeof(header) / sizeof(word);
+    louds_.bits = p;
+    louds_.size = louds;
+    p += bit_words(louds);
+    louds_.ranks = p;
+    p += rank_words(louds);
+    samples_ = p;
+    p += sample_words(nodes_ + 1);
+    terminal_.bits = p;
+    terminal_.size = nodes_;
+    p += bit_words(nodes_);
+    terminal_.ranks = p;
+    p += rank_words(nodes_);
+    labels_ = reinterpret_cast<const unsigned char *>(p);
+  }
+
+  /**
+   * Check the sections against what the queries rely on, so a corrupt file
+   * cannot make them read out of bounds or loop forever.
+   */
+  void validate() const {
+    const std::runtime_error invalid("static_trie: invalid data");
+
+    // Superroot "10", and the last bit closes the last node
+    if (!louds_.get(0) || louds_.get(1) || louds_.get(louds_.size - 1))
+      throw invalid;
+    size_t ones = 0, zeros = 0;
+    for (size_t i = 0; i < louds_.size; ++i) {
+      if (louds_.get(i)) {
+        ++ones;
+        continue;
+      }
+      if (zeros % sample_rate == 0 &&
+          samples_[zeros / sample_rate] != i / 64 / block_words)
+        throw invalid;
+      // Zero v is followed by the children of node v, so nodes 0 to v must
+      // already have been counted
+      if (++zeros <= nodes_ && ones < zeros)
+        throw invalid;
+    }
+    if (ones != nodes_)
+      throw invalid;
+
+    // Rank directories, which also rules out stray bits past the end
+    std::vector<word> ranks(rank_words(louds_.size));
+    build_ranks(louds_.bits, louds_.size, ranks.data());
+    if (!std::equal(ranks.begin(), ranks.end(), louds_.ranks))
+      throw invalid;
+    ranks.assign(rank_words(nodes_), 0);
+    build_ranks(terminal_.bits, nodes_, ranks.data());
+    if (!std::equal(ranks.begin(), ranks.end(), terminal_.ranks) ||
+        ranks.back() != keys_)
+      throw invalid;
+  }
+
+  static void build_ranks(const word *bits, size_t bits_size, word *ranks) {
+    const auto words = bit_words(bits_size);
+    word r = 0;
+    for (size_t i = 0; i < words; ++i) {
+      if (i % block_words == 0)
+        ranks[i / block_words] = r;
+      r += static_cast<word>(__builtin_popcountll(bits[i]));
+    }
+    ranks[rank_words(bits_size) - 1] = r;
+  }
+
+  /**
+   * Build the LOUDS representation from sorted, unique keys.
+   * @param keys Keys in std::string order
+   */
+  void build(const std::vector<std::string> &keys) {
+    struct range {
+      size_t lo, hi, depth; //!< Keys sharing the path to a node
+    };
+    std::vector<bool> louds{true, false};
+    std::vector<bool> terminal;
+    std::vector<unsigned char> labels{0};
+    std::vector<range> level{{0, keys.size(), 0}};
+
+    // Breadth-first, one level at a time, so children are numbered in order
+    while (!level.empty()) {
+      std::vector<range> next;
+      for (const auto &r : level) {
+        auto i = r.lo;
+        const bool end = i < r.hi && keys[i].size() == r.depth;
+        terminal.push_back(end);
+        i += end;
+        while (i < r.hi) {
+          const auto c = keys[i][r.depth];
+          auto j = i + 1;
+          while (j < r.hi && keys[j][r.depth] == c)
+            ++j;
+          louds.push_back(true);
+          labels.push_back(static_cast<unsigned char>(c));
+          next.push_back({i, j, r.depth + 1});
+          i = j;
+        }
+        louds.push_back(false);
+      }
+      level.swap(next);
+    }
+
+    const auto nodes = terminal.size();
+    buf_.assign(total_words(nodes), 0);
+    *reinterpret_cast<header *>(buf_.data()) = {magic, nodes, keys.size()};
+    attach(buf_.data(), buf_.size());
+
+    auto bits = const_cast<word *>(louds_.bits);
+    for (size_t i = 0; i < louds.size(); ++i)
+      bits[i / 64] |= word(louds[i]) << (i % 64);
+    build_ranks(bits, louds.size(), const_cast<word *>(louds_.ranks));
+
+    auto samples = const_cast<word *>(samples_);
+    for (size_t i = 0, zeros = 0; i < louds.size(); ++i) {
+      if (!louds[i] && zeros++ % sample_rate == 0)
+        samples[(zeros - 1) / sample_rate] = i / 64 / block_words;
+    }
+
+    bits = const_cast<word *>(terminal_.bits);
+    for (size_t i = 0; i < nodes; ++i)
+      bits[i / 64] |= word(terminal[i]) << (i % 64);
+    build_ranks(bits, nodes, const_cast<word *>(terminal_.ranks));
+
+    std::copy(labels.begin(), labels.end(),
+              const_cast<unsigned char *>(labels_));
+  }
+
+  /**
+   * Find the position of a zero in the LOUDS bits.
+   * @param  i Index of the zero, counting from 0
+   * @return   Bit position of the zero
+   */
+  size_t select0(size_t i) const {
+    // Binary search the rank directory between the surrounding samples
+    auto lo = samples_[i / sample_rate];
+    auto hi = i / sample_rate + 1 < sample_words(nodes_ + 1)
+                  ? samples_[i / sample_rate + 1] + 1
+                  : rank_words(louds_.size) - 1;
+    while (hi - lo > 1) {
+      const auto mid = lo + (hi - lo) / 2;
+      if (mid * block_words * 64 - louds_.ranks[mid] <= i)
+        lo = mid;
+      else
+        hi = mid;
+    }
+
+    // Scan the words in the block
+    auto zeros = lo * block_words * 64 - louds_.ranks[lo];
+    auto w = lo * block_words;
+    while (true) {
+      const auto z = static_cast<size_t>(__builtin_popcountll(~louds_.bits[w]));
+      if (zeros + z > i)
+        break;
+      zeros += z;
+      ++w;
+    }
+
+    // Select within the word
+    auto inv = ~louds_.bits[w];
+    for (auto k = i - zeros; k > 0; --k)
+      inv &= inv - 1;
+    return w * 64 + static_cast<size_t>(__builtin_ctzll(inv));
+  }
+
+  /**
+   * Find the first zero at or after a position in the LOUDS bits.
+   */
+  size_t next_zero(size_t i) const {
+    auto w = i / 64;
+    auto inv = ~louds_.bits[w] & (~word(0) << (i % 64));
+    while (!inv)
+      inv = ~louds_.bits[++w];
+    return w * 64 + static_cast<size_t>(__builtin_ctzll(inv));
+  }
+
+  /**
+   * Get the range of child node ids of a node.
+   * @param  v Node id
+   * @return   Half open range of child ids, with labels in increasing order
+   */
+  std::pair<size_t, size_t> children(size_t v) const {
+    const auto start = select0(v) + 1;
+    const auto end = next_zero(start);
+    return {start - v - 1, end - v - 1};
+  }
+
+  /**
+   * Follow one labelled edge down from a node.
+   * @return Child node id, or npos if there is no such edge
+   */
+  size_t child(size_t v, char c) const {
+    const auto r = children(v);
+    const auto label = static_cast<unsigned char>(c);
+    const auto it = std::lower_bound(labels_ + r.first, labels_ + r.second,
+                                     label);
+    if (it == labels_ + r.second || *it != label)
+      return npos;
+    return static_cast<size_t>(it - labels_);
+  }
+
+  size_t find_node(const std::string &s) const {
+    size_t v = 0;
+    for (const auto c : s) {
+      v = child(v, c);
+      if (v == npos)
+        return npos;
+    }
+    return v;
+  }
+
+  void unmap() {
+    if (map_)
+      munmap(map_, map_size_);
+    map_ = nullptr;
+    map_size_ = 0;
+  }
+
+  static_trie() = default;
+
+public:
+  /**
+   * Forward iterator over the keys below a node, in lexicographic order.
+   */
+  class const_iterator {
+    friend class static_trie;
+
+    struct frame {
+      size_t next, end; //!< Children of the node not yet visited
+    };
+    const static_trie *t_ = nullptr;
+    std::vector<frame> stack_;
+    std::vector<size_t> nodes_; //!< Node at each level of stack_
+    std::string key_;
+
+    const_iterator(const static_trie *t, size_t v, std::string prefix)
+        : t_(t), key_(std::move(prefix)) {
+      if (v == npos)
+        return;
+      push(v);
+      if (!t_->terminal_.get(v))
+        advance();
+    }
+
+    void push(size_t v) {
+      const auto r = t_->children(v);
+      stack_.push_back({r.first, r.second});
+      nodes_.push_back(v);
+    }
+
+    void advance() {
+      while (!stack_.empty()) {
+        auto &top = stack_.back();
+        if (top.next == top.end) {
+          stack_.pop_back();
+          nodes_.pop_back();
+          if (!stack_.empty())
+            key_.pop_back();
+          continue;
+        }
+        const auto v = top.next++;
+        key_.push_back(static_cast<char>(t_->labels_[v]));
+        push(v);
+        if (t_->terminal_.get(v))
+          return;
+      }
+    }
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef std::string value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const std::string *pointer;
+    typedef const std::string &reference;
+
+    const_iterator() = default;
+
+    reference operator*() const { return key_; }
+    pointer operator->() const { return &key_; }
+
+    const_iterator &operator++() {
+      advance();
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      auto tmp = *this;
+      advance();
+      return tmp;
+    }
+
+    friend bool operator==(const const_iterator &a, const const_iterator &b) {
+      if (a.nodes_.empty() || b.nodes_.empty())
+        return a.nodes_.empty() == b.nodes_.empty();
+      return a.nodes_.back() == b.nodes_.back();
+    }
+
+    friend bool operator!=(const const_iterator &a, const const_iterator &b) {
+      return !(a == b);
+    }
+  };
+
+  /**
+   * Range of the keys sharing a prefix, as returned by starts_with.
+   */
+  class prefix_range {
+    const_iterator first_;
+
+  public:
+    explicit prefix_range(const_iterator first) : first_(std::move(first)) {}
+    const_iterator begin() const { return first_; }
+    const_iterator end() const { return const_iterator(); }
+    bool empty() const { return first_ == const_iterator(); }
+  };
+
+  /**
+   * Build from a range of strings. Duplicates are ignored.
+   * @param first Start of the strings
+   * @param last  End of the strings
+   */
+  template <class InputIt> static_trie(InputIt first, InputIt last) {
+    std::vector<std::string> keys(first, last);
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    build(keys);
+  }
+
+  static_trie(const static_trie &) = delete;
+  static_trie &operator=(const static_trie &) = delete;
+
+  static_trie(static_trie &&x) noexcept { *this = std::move(x); }
+
+  static_trie &operator=(static_trie &&x) noexcept {
+    if (this != &x) {
+      unmap();
+      buf_ = std::move(x.buf_);
+      std::swap(map_, x.map_);
+      std::swap(map_size_, x.map_size_);
+      nodes_ = x.nodes_;
+      keys_ = x.keys_;
+      louds_ = x.louds_;
+      samples_ = x.samples_;
+      terminal_ = x.terminal_;
+      labels_ = x.labels_;
+    }
+    return *this;
+  }
+
+  ~static_trie() { unmap(); }
+
+  /**
+   * Memory map a file written by save(). Queries read the file directly,
+   * after one pass over the bitvectors checks that it is well formed.
+   * Throws std::runtime_error if it is not.
+   * @param  path File to open
+   * @return      Trie backed by the mapping
+   */
+  static static_trie open(const std::string &path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw std::runtime_error("static_trie: cannot open " + path);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 ||
+        st.st_size % static_cast<off_t>(sizeof(word)) != 0) {
+      ::close(fd);
+      throw std::runtime_error("static_trie: invalid file " + path);
+    }
+    const auto size = static_cast<size_t>(st.st_size);
+    void *p = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+      throw std::runtime_error("static_trie: cannot map " + path);
+
+    static_trie t;
+    t.map_ = p;
+    t.map_size_ = size;
+    t.attach(static_cast<const word *>(p), size / sizeof(word));
+    t.validate();
+    return t;
+  }
+
+  /**
+   * Write the trie to a file that can be loaded with open().
+   * @param path File to write
+   */
+  void save(const std::string &path) const {
+    const auto f = std::fopen(path.c_str(), "wb");
+    if (!f)
+      throw std::runtime_error("static_trie: cannot create " + path);
+    const auto base = louds_.bits - sizeof(header) / sizeof(word);
+    const auto words = total_words(nodes_);
+    const auto written = std::fwrite(base, sizeof(word), words, f);
+    if (std::fclose(f) != 0 || written != words)
+      throw std::runtime_error("static_trie: cannot write " + path);
+  }
+
+  /**
+   * Test if a string is present in the container.
+   * @param  s String to test
+   * @return   Returns true if found
+   */
+  bool find(const std::string &s) const {
+    const auto v = find_node(s);
+    return v != npos && terminal_.get(v);
+  }
+
+  /**
+   * Count the keys beginning with a prefix.
+   *
+   * A subtree occupies a contiguous range of node ids on every level, so this
+   * only needs two selects and two ranks per level below the prefix.
+   *
+   * @param  prefix Prefix to search for
+   * @return        Number of matching keys
+   */
+  size_t count_prefix(const std::string &prefix) const {
+    const auto v = find_node(prefix);
+    if (v == npos)
+      return 0;
+    size_t count = 0;
+    for (size_t lo = v, hi = v + 1; lo < hi;) {
+      count += terminal_.rank1(hi) - terminal_.rank1(lo);
+      const auto next_lo = select0(lo) - lo;
+      hi = select0(hi) - hi;
+      lo = next_lo;
+    }
+    return count;
+  }
+
+  /**
+   * Find the longest key in the trie that is a prefix of a string.
+   * @param  s String to match against
+   * @return   Length of the longest matching key, or std::string::npos if no
+   *           key matches
+   */
+  size_t longest_prefix_match(const std::string &s) const {
+    size_t v = 0;
+    auto match = terminal_.get(0) ? 0 : std::string::npos;
+    for (size_t i = 0; i < s.size(); ++i) {
+      v = child(v, s[i]);
+      if (v == npos)
+        break;
+      if (terminal_.get(v))
+        match = i + 1;
+    }
+    return match;
+  }
+
+  /**
+   * Lazily enumerate every key beginning with a prefix.
+   * @param  prefix Prefix to search for
+   * @return        Range of matching keys in lexicographic order
+   */
+  prefix_range starts_with(const std::string &prefix) const {
+    return prefix_range(const_iterator(this, find_node(prefix), prefix));
+  }
+
+  const_iterator begin() const { return const_iterator(this, 0, ""); }
+  const_iterator end() const { return const_iterator(); }
+
+  size_t size() const noexcept { return keys_; }
+
+  bool empty() const noexcept { return keys_ == 0; }
+
+  /**
+   * Get the size of the serialized representation.
+   * @return Size in bytes
+   */
+  size_t bytes() const noexcept { return total_words(nodes_) * sizeof(word); }
+};
+
+/**
+ * Convert a trie into its immutable, succinct form.
+ * @param  t Trie to convert
+ * @return   Static trie holding the same keys
+ */
+template <class Allocator>
+static_trie freeze(const basic_trie<Allocator> &t) {
+  return static_trie(t.begin(), t.end());
+}
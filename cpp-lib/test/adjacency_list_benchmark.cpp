@@ -0,0 +1,104 @@
+// Building and traversing a random graph with adjacency_list against
+// boost::adjacency_list.
+//
+// Usage: adjacency_list_benchmark [largest number of vertices]
+//                                 [benchmark options]
+
+#include "adjacency_list.h"
+#include "benchmark.h"
+
+#include <boost/graph/adjacency_list.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::directedS,
+                              boost::no_property,
+                              boost::property<boost::edge_weight_t, int>>
+    boost_graph;
+
+// Breadth-first search from vertex 0, returning the number reached
+template <class Neighbors>
+static size_t bfs(size_t n, Neighbors neighbors) {
+  vector<char> seen(n, 0);
+  vector<size_t> queue{0};
+  seen[0] = 1;
+  for (size_t i = 0; i < queue.size(); ++i) {
+    neighbors(queue[i], [&](size_t d) {
+      if (!seen[d]) {
+        seen[d] = 1;
+        queue.push_back(d);
+      }
+    });
+  }
+  return queue.size();
+}
+
+int main(int argc, char **argv) {
+  benchmark_suite s("adjacency_list", argc, argv);
+  const auto largest = s.size(s.arg(0, 1000000));
+
+  for (const auto d : {distribution::uniform, distribution::skewed}) {
+    for (size_t n = 1000; n <= largest; n *= 10) {
+      // Eight edges per vertex
+      auto ends = make_keys(d, 16 * n);
+      for (auto &e : ends)
+        e %= n;
+      const auto m = ends.size() / 2;
+      const auto name = string(to_string(d)) + "/" + to_string(n) + "/";
+
+      s.run("build/" + name + "adjacency_list", m, [&] {
+        adjacency_list<weighted> g(n);
+        for (size_t i = 0; i < ends.size(); i += 2)
+          g.add_edge(ends[i], ends[i + 1], static_cast<int>(i));
+        return g.size();
+      });
+      s.run("build/" + name + "boost::adjacency_list", m, [&] {
+        boost_graph g(n);
+        for (size_t i = 0; i < ends.size(); i += 2)
+          boost::add_edge(ends[i], ends[i + 1], static_cast<int>(i), g);
+        return boost::num_vertices(g);
+      });
+
+      adjacency_list<weighted> g(n);
+      boost_graph b(n);
+      for (size_t i = 0; i < ends.size(); i += 2) {
+        g.add_edge(ends[i], ends[i + 1], static_cast<int>(i));
+        boost::add_edge(ends[i], ends[i + 1], static_cast<int>(i), b);
+      }
+
+      s.run("bfs/" + name + "adjacency_list", m, [&] {
+        return bfs(n, [&](size_t v, auto visit) {
+          for (const auto &e : g.neighbors(v))
+            visit(e.get_dest());
+        });
+      });
+      s.run("bfs/" + name + "boost::adjacency_list", m, [&] {
+        return bfs(n, [&](size_t v, auto visit) {
+          for (const auto e :
+               boost::make_iterator_range(boost::out_edges(v, b)))
+            visit(boost::target(e, b));
+        });
+      });
+
+      s.run("sum_weights/" + name + "adjacency_list", m, [&] {
+        long long sum = 0;
+        for (size_t v = 0; v < n; ++v)
+          for (const auto &e : g.neighbors(v))
+            sum += e.get_weight();
+        return sum;
+      });
+      s.run("sum_weights/" + name + "boost::adjacency_list", m, [&] {
+        const auto weight = boost::get(boost::edge_weight, b);
+        long long sum = 0;
+        for (size_t v = 0; v < n; ++v)
+          for (const auto e :
+               boost::make_iterator_range(boost::out_edges(v, b)))
+            sum += boost::get(weight, e);
+        return sum;
+      });
+    }
+  }
+}
@@ -2,6 +2,8 @@
 #define BOOST_TEST_MODULE adjacency_list_test
 #include <boost/test/unit_test.hpp>
 
+#include "arena.h"
+
 using namespace std;
 
 BOOST_AUTO_TEST_CASE(constructors_test) {
@@ -34,3 +36,20 @@ BOOST_AUTO_TEST_CASE(add_edge_test) {
     BOOST_CHECK_EQUAL(2, a.neighbors(i).size());
   }
 }
+
+BOOST_AUTO_TEST_CASE(allocator_test) {
+  const size_t N = 100;
+  arena r;
+  ::pmr::adjacency_list<weighted> a(N, &r);
+  BOOST_CHECK_EQUAL(a.size(), N);
+  const auto used = r.used();
+  BOOST_CHECK_GT(used, 0);
+
+  for (size_t i = 0; i < N; ++i)
+    a.add_edge(i, (i + 1) % N, static_cast<int>(i));
+  BOOST_CHECK_GT(r.used(), used);
+  BOOST_CHECK(a.get_allocator().resource() == &r);
+  BOOST_CHECK(a.neighbors(0).get_allocator().resource() == &r);
+  BOOST_CHECK_EQUAL(a.neighbors(5)[0].get_dest(), 6);
+  BOOST_CHECK_EQUAL(a.neighbors(5)[0].get_weight(), 5);
+}
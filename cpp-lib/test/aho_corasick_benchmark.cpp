@@ -0,0 +1,59 @@
+// Measures Aho-Corasick scan throughput for a large keyword set, feeding the
+// text in 64 KB chunks as if it were read from a file or pipe.
+//
+// Usage: aho_corasick_benchmark [number of keywords] [MB of text]
+//                               [benchmark options]
+
+#include "aho_corasick.h"
+#include "benchmark.h"
+
+#include <random>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char **argv) {
+  benchmark_suite s("aho_corasick", argc, argv);
+  const auto N = s.size(s.arg(0, 100000));
+  const auto MB = s.arg(1, 64);
+  mt19937_64 rng(4); // Consistent input between runs
+
+  trie t;
+  for (size_t i = 0; i < N; ++i) {
+    string w(4 + rng() % 9, 'a');
+    for (auto &c : w)
+      c = static_cast<char>('a' + rng() % 26);
+    t.insert(w);
+  }
+
+  s.run("build/" + to_string(N), t.size(),
+        [&] { return aho_corasick(t).states(); });
+  const aho_corasick ac(t);
+
+  // Log-like text: words from the keyword set mixed with random words
+  const size_t chunk = 64 * 1024;
+  string text;
+  while (text.size() < chunk * 16) {
+    if (rng() % 4 == 0) {
+      text += ac.pattern(rng() % ac.size());
+    } else {
+      for (size_t i = 0, len = 2 + rng() % 8; i < len; ++i)
+        text += static_cast<char>('a' + rng() % 26);
+    }
+    text += ' ';
+  }
+
+  size_t matches = 0;
+  const auto total = s.size(MB * 1024 * 1024 / chunk) * chunk;
+  auto &r = s.run("scan/" + to_string(N), total, [&] {
+    matches = 0;
+    auto stream = ac.make_stream();
+    for (size_t done = 0; done < total; done += chunk) {
+      const auto off = (done / chunk) % 16 * chunk;
+      stream.feed(text.data() + off, chunk,
+                  [&](size_t, size_t) { ++matches; });
+    }
+  });
+  r.metric("states", static_cast<double>(ac.states()))
+      .metric("matches", static_cast<double>(matches));
+}
@@ -0,0 +1,115 @@
+#include "aho_corasick.h"
+#define BOOST_TEST_MODULE aho_corasick_test
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+typedef vector<pair<size_t, size_t>> matches;
+
+static matches brute_force(const aho_corasick &ac, const string &text) {
+  matches m;
+  for (size_t i = 0; i < text.size(); ++i)
+    for (size_t id = 0; id < ac.size(); ++id)
+      if (text.compare(i, ac.pattern(id).size(), ac.pattern(id)) == 0)
+        m.emplace_back(i, id);
+  sort(m.begin(), m.end());
+  return m;
+}
+
+static matches find_all(const aho_corasick &ac, const string &text) {
+  matches m;
+  ac.find_all(text, [&](size_t pos, size_t id) { m.emplace_back(pos, id); });
+  sort(m.begin(), m.end());
+  return m;
+}
+
+BOOST_AUTO_TEST_CASE(empty_test) {
+  trie t;
+  t.insert("");
+  aho_corasick ac(t);
+  BOOST_CHECK_EQUAL(ac.size(), 0);
+  BOOST_CHECK(find_all(ac, "abc").empty());
+}
+
+BOOST_AUTO_TEST_CASE(overlap_test) {
+  trie t;
+  for (const auto s : {"he", "she", "his", "hers"})
+    t.insert(s);
+  aho_corasick ac(t);
+  BOOST_CHECK_EQUAL(ac.size(), 4);
+
+  // Patterns are numbered in trie order: he, hers, his, she
+  BOOST_CHECK_EQUAL(ac.pattern(0), "he");
+  const matches expect{{1, 3}, {2, 0}, {2, 1}};
+  BOOST_CHECK(find_all(ac, "ushers") == expect);
+}
+
+BOOST_AUTO_TEST_CASE(random_test) {
+  srand(4); // Consistent numbers for testing
+  trie t;
+  for (int i = 0; i < 200; ++i) {
+    string s(1 + rand() % 5, 'a');
+    for (auto &c : s)
+      c = static_cast<char>('a' + rand() % 3);
+    t.insert(s);
+  }
+  aho_corasick ac(t);
+
+  string text(5000, 'a');
+  for (auto &c : text)
+    c = static_cast<char>('a' + rand() % 4);
+  BOOST_CHECK(find_all(ac, text) == brute_force(ac, text));
+}
+
+BOOST_AUTO_TEST_CASE(all_bytes_test) {
+  // Patterns using every byte value, so no byte falls in the unused column
+  srand(4);
+  trie t;
+  for (int b = 0; b < 256; ++b)
+    t.insert(string(1, static_cast<char>(b)) + static_cast<char>(255 - b));
+  t.insert(string(2, static_cast<char>(0xff)));
+  aho_corasick ac(t);
+
+  string text(5000, 'a');
+  for (auto &c : text)
+    c = static_cast<char>(rand() % 2 ? 0xff : rand() % 256);
+  BOOST_CHECK(find_all(ac, text) == brute_force(ac, text));
+}
+
+BOOST_AUTO_TEST_CASE(stream_test) {
+  srand(4); // Consistent numbers for testing
+  trie t;
+  for (int i = 0; i < 100; ++i) {
+    string s(1 + rand() % 8, 'a');
+    for (auto &c : s)
+      c = static_cast<char>('a' + rand() % 2);
+    t.insert(s);
+  }
+  aho_corasick ac(t);
+
+  string text(5000, 'a');
+  for (auto &c : text)
+    c = static_cast<char>('a' + rand() % 3);
+
+  // Feed random sized chunks, so matches straddle the boundaries
+  matches m;
+  auto s = ac.make_stream();
+  for (size_t i = 0; i < text.size();) {
+    const auto n = min<size_t>(text.size() - i, rand() % 16);
+    s.feed(text.data() + i, n,
+           [&](size_t pos, size_t id) { m.emplace_back(pos, id); });
+    i += n;
+  }
+  BOOST_CHECK_EQUAL(s.offset(), text.size());
+  sort(m.begin(), m.end());
+  BOOST_CHECK(m == brute_force(ac, text));
+
+  s.reset();
+  BOOST_CHECK_EQUAL(s.offset(), 0);
+}
@@ -0,0 +1,65 @@
+// Builds and tears down a small set of containers per simulated request, with
+// std::allocator against an arena that is released after each request.
+//
+// Usage: arena_benchmark [number of requests] [keys per request]
+//                        [benchmark options]
+
+#include "arena.h"
+#include "benchmark.h"
+#include "flat_set.h"
+#include "lru_cache.h"
+#include "trie.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Work done by one request, with every container using the same allocator
+template <class Set, class Trie, class Cache, class Alloc>
+static size_t request(const vector<uint64_t> &keys,
+                      const vector<string> &words, const Alloc &alloc) {
+  Set s(alloc);
+  Trie t(alloc);
+  Cache c(keys.size() / 4 + 1, alloc);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    s.insert(keys[i]);
+    t.insert(words[i]);
+    c.insert(keys[i], i);
+  }
+  return s.size() + t.size() + c.size();
+}
+
+int main(int argc, char **argv) {
+  benchmark_suite s("arena", argc, argv);
+  const auto requests = s.size(s.arg(0, 10000));
+  const auto per_request = s.arg(1, 200);
+
+  auto keys = make_keys(distribution::uniform, per_request);
+  vector<string> words;
+  for (const auto k : keys)
+    words.push_back(to_string(k % 1000000));
+  const auto ops = requests * per_request;
+
+  s.run("std::allocator/" + to_string(per_request), ops, [&] {
+    size_t total = 0;
+    for (size_t r = 0; r < requests; ++r)
+      total += request<flat_set<uint64_t>, trie, lru_cache<uint64_t, size_t>>(
+          keys, words, std::allocator<char>());
+    return total;
+  });
+
+  arena a;
+  auto &r = s.run("arena/" + to_string(per_request), ops, [&] {
+    size_t total = 0;
+    for (size_t i = 0; i < requests; ++i) {
+      total += request<::pmr::flat_set<uint64_t>, ::pmr::trie,
+                       ::pmr::lru_cache<uint64_t, size_t>>(
+          keys, words, std::pmr::polymorphic_allocator<char>(&a));
+      a.release();
+    }
+    return total;
+  });
+  r.metric("arena_bytes", static_cast<double>(a.capacity()));
+}
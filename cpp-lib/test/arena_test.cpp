@@ -0,0 +1,164 @@
+#include "arena.h"
+#define BOOST_TEST_MODULE arena_test
+#include <boost/test/unit_test.hpp>
+
+#include "flat_set.h"
+#include "lru_cache.h"
+#include "trie.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Counts the blocks an arena takes from upstream
+class counting_resource : public std::pmr::memory_resource {
+  void *do_allocate(size_t bytes, size_t align) override {
+    ++allocations;
+    live += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+
+  void do_deallocate(void *p, size_t bytes, size_t align) override {
+    live -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+
+  bool do_is_equal(const memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+public:
+  size_t allocations = 0;
+  size_t live = 0;
+};
+
+BOOST_AUTO_TEST_CASE(constructors_test) {
+  counting_resource up;
+  {
+    arena a(1024, &up);
+    BOOST_CHECK_EQUAL(a.used(), 0);
+    BOOST_CHECK_EQUAL(a.capacity(), 0);
+    BOOST_CHECK_EQUAL(a.upstream_resource(), &up);
+    BOOST_CHECK_EQUAL(up.allocations, 0);
+    BOOST_CHECK(a.is_equal(a));
+
+    arena b(1024, &up);
+    BOOST_CHECK(!a.is_equal(b));
+  }
+  BOOST_CHECK_EQUAL(up.live, 0);
+}
+
+BOOST_AUTO_TEST_CASE(allocate_test) {
+  counting_resource up;
+  {
+    arena a(1024, &up);
+    std::vector<void *> ptrs;
+    for (size_t i = 0; i < 1000; ++i) {
+      const size_t align = size_t(1) << (i % 5);
+      const auto p = a.allocate(1 + i % 100, align);
+      BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(p) % align, 0);
+      ptrs.push_back(p);
+    }
+    // Blocks double in size, so only a few are needed
+    BOOST_CHECK_LT(up.allocations, 10);
+    BOOST_CHECK_LE(a.used(), a.capacity());
+    BOOST_CHECK_EQUAL(a.capacity(), up.live);
+
+    // Larger than any block so far
+    BOOST_CHECK(a.allocate(1 << 20, 64));
+    BOOST_CHECK_GE(a.capacity(), 1 << 20);
+
+    for (const auto p : ptrs)
+      a.deallocate(p, 1);
+  }
+  BOOST_CHECK_EQUAL(up.live, 0);
+}
+
+BOOST_AUTO_TEST_CASE(release_test) {
+  counting_resource up;
+  arena a(256, &up);
+  a.release();
+  BOOST_CHECK_EQUAL(a.capacity(), 0);
+
+  for (size_t i = 0; i < 100; ++i)
+    BOOST_CHECK(a.allocate(100, 8));
+  const auto allocations = up.allocations;
+  BOOST_CHECK_GT(allocations, 1);
+
+  a.release();
+  BOOST_CHECK_EQUAL(a.used(), 0);
+  BOOST_CHECK_EQUAL(a.capacity(), up.live);
+  const auto kept = a.capacity();
+
+  // The kept block serves requests that fit in it without going upstream
+  for (size_t i = 0; i < kept / 200; ++i)
+    BOOST_CHECK(a.allocate(100, 8));
+  BOOST_CHECK_EQUAL(up.allocations, allocations);
+  BOOST_CHECK_EQUAL(a.capacity(), kept);
+}
+
+BOOST_AUTO_TEST_CASE(reuse_test) {
+  // The same request served repeatedly, releasing between requests
+  const auto request = [](std::pmr::memory_resource *r) {
+    for (size_t i = 0; i < 1000; ++i)
+      BOOST_CHECK(r->allocate(64, 8));
+  };
+
+  // Blocks double, so within a few requests the kept one fits a request
+  counting_resource up;
+  arena a(256, &up);
+  for (int round = 0; round < 3; ++round) {
+    request(&a);
+    a.release();
+  }
+  const auto warm = up.allocations;
+  for (int round = 0; round < 10; ++round) {
+    request(&a);
+    a.release();
+  }
+  BOOST_CHECK_EQUAL(up.allocations, warm);
+
+  // Unlike monotonic_buffer_resource, which grows from scratch every time
+  counting_resource mono_up;
+  std::pmr::monotonic_buffer_resource m(256, &mono_up);
+  for (int round = 0; round < 3; ++round) {
+    request(&m);
+    m.release();
+  }
+  const auto mono_warm = mono_up.allocations;
+  for (int round = 0; round < 10; ++round) {
+    request(&m);
+    m.release();
+  }
+  BOOST_CHECK_GT(mono_up.allocations, mono_warm + 10);
+}
+
+BOOST_AUTO_TEST_CASE(containers_test) {
+  counting_resource up;
+  arena a(4096, &up);
+  for (int round = 0; round < 3; ++round) {
+    {
+      ::pmr::flat_set<int> s(&a);
+      for (int i = 0; i < 1000; ++i)
+        s.insert((i * 7919) % 1000);
+      BOOST_CHECK_EQUAL(s.size(), 1000);
+
+      ::pmr::trie t(&a);
+      for (int i = 0; i < 1000; ++i)
+        t.insert(to_string(i));
+      BOOST_CHECK_EQUAL(t.size(), 1000);
+      BOOST_CHECK(t.find("999"));
+
+      ::pmr::lru_cache<int, string> c(100, &a);
+      for (int i = 0; i < 1000; ++i)
+        c.insert(i, to_string(i));
+      BOOST_CHECK_EQUAL(c.size(), 100);
+      BOOST_CHECK_EQUAL(c.get(999), "999");
+    }
+    a.release();
+  }
+  // Only the largest block survives between rounds
+  BOOST_CHECK_EQUAL(a.capacity(), up.live);
+}
@@ -0,0 +1,373 @@
+#pragma once
+
+/**
+ * Harness shared by the *_benchmark.cpp programs.
+ *
+ * Each case runs a number of times and the fastest repetition is reported as
+ * ns/op and ops/s, together with the heap allocations it made, the peak heap
+ * it held and the peak RSS of the process so far. Results go to stdout as a
+ * table and, with --json, to a file that can be diffed between versions.
+ *
+ * The harness replaces the global operator new and delete to count heap
+ * use, so it must be included from exactly one translation unit.
+ *
+ * Options understood by every benchmark:
+ *   --json FILE   Also write the results as JSON
+ *   --repeat N    Repetitions per case, default 3
+ *   --filter STR  Only run cases whose name contains STR
+ *   --quick       Shrink problem sizes 100 times, for smoke testing
+ * Everything else is left as positional arguments for the benchmark.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include <numeric>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace detail {
+
+struct heap_counters {
+  std::atomic<std::size_t> allocations{0};
+  std::atomic<std::size_t> allocated{0}; //!< Bytes ever allocated
+  std::atomic<std::size_t> live{0};      //!< Bytes currently allocated
+  std::atomic<std::size_t> peak{0};      //!< High water mark of live
+};
+
+inline heap_counters &heap() {
+  static heap_counters h;
+  return h;
+}
+
+} // namespace detail
+
+// Kept out of line: once inlined, GCC sees malloc paired with delete and
+// warns about mismatched allocation functions
+__attribute__((noinline)) void *operator new(std::size_t n) {
+  void *p = std::malloc(n ? n : 1);
+  if (!p)
+    throw std::bad_alloc();
+  auto &h = detail::heap();
+  const auto size = malloc_usable_size(p);
+  h.allocations.fetch_add(1, std::memory_order_relaxed);
+  h.allocated.fetch_add(size, std::memory_order_relaxed);
+  const auto live = h.live.fetch_add(size, std::memory_order_relaxed) + size;
+  auto peak = h.peak.load(std::memory_order_relaxed);
+  while (live > peak &&
+         !h.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    ;
+  return p;
+}
+
+void *operator new[](std::size_t n) { return operator new(n); }
+
+__attribute__((noinline)) void operator delete(void *p) noexcept {
+  if (p)
+    detail::heap().live.fetch_sub(malloc_usable_size(p),
+                                  std::memory_order_relaxed);
+  std::free(p);
+}
+
+void operator delete[](void *p) noexcept { operator delete(p); }
+void operator delete(void *p, std::size_t) noexcept { operator delete(p); }
+void operator delete[](void *p, std::size_t) noexcept { operator delete(p); }
+
+/**
+ * Key orders and distributions shared by the benchmarks
+ */
+enum class distribution {
+  uniform,    //!< Random 64 bit keys
+  sorted,     //!< Ascending
+  reversed,   //!< Descending
+  few_unique, //!< Random keys from a set of 64
+  skewed      //!< Keys drawn with probability proportional to 1/rank
+};
+
+inline const char *to_string(distribution d) {
+  switch (d) {
+  case distribution::uniform:
+    return "uniform";
+  case distribution::sorted:
+    return "sorted";
+  case distribution::reversed:
+    return "reversed";
+  case distribution::few_unique:
+    return "few_unique";
+  case distribution::skewed:
+    return "skewed";
+  }
+  return "";
+}
+
+/**
+ * Generate keys, the same ones on every run.
+ * @param  d Distribution
+ * @param  n Number of keys
+ * @return   The keys
+ */
+inline std::vector<std::uint64_t> make_keys(distribution d, std::size_t n) {
+  std::mt19937_64 rng(4);
+  std::vector<std::uint64_t> keys(n);
+  switch (d) {
+  case distribution::uniform:
+    for (auto &k : keys)
+      k = rng();
+    break;
+  case distribution::sorted:
+    std::iota(keys.begin(), keys.end(), std::uint64_t(0));
+    break;
+  case distribution::reversed:
+    std::iota(keys.rbegin(), keys.rend(), std::uint64_t(0));
+    break;
+  case distribution::few_unique:
+    for (auto &k : keys)
+      k = rng() % 64;
+    break;
+  case distribution::skewed: {
+    std::uniform_real_distribution<double> u(0, 1);
+    const auto log_n = std::log(static_cast<double>(n));
+    for (auto &k : keys)
+      k = std::min<std::uint64_t>(
+          static_cast<std::uint64_t>(std::exp(u(rng) * log_n)) - 1, n - 1);
+    break;
+  }
+  }
+  return keys;
+}
+
+class benchmark_suite {
+  typedef std::size_t size_t;
+
+public:
+  /**
+   * Measurements of one case. Benchmarks can attach their own metrics.
+   */
+  struct result {
+    std::string name;
+    size_t ops = 0;
+    double seconds = 0;      //!< Fastest repetition, at least one tick
+    size_t allocations = 0;  //!< Heap allocations in one repetition
+    size_t allocated = 0;    //!< Bytes allocated in one repetition
+    size_t peak_heap = 0;    //!< Most bytes held at once, beyond the start
+    long peak_rss_kb = 0;    //!< Peak resident set of the process so far
+    std::vector<std::pair<std::string, double>> metrics;
+
+    result &metric(const std::string &key, double value) {
+      metrics.emplace_back(key, value);
+      return *this;
+    }
+  };
+
+private:
+  std::string name_;
+  std::string json_;
+  std::string filter_;
+  size_t repeat_ = 3;
+  size_t scale_ = 1;
+  std::vector<std::string> args_;
+  std::vector<result> results_;
+  size_t printed_ = 0; //!< Results are printed once their metrics are in
+  result skipped_;
+
+  static void print(const result &r) {
+    const auto ops = static_cast<double>(std::max<size_t>(r.ops, 1));
+    std::printf("%-52s %10.1f ns/op %9.3f Mops/s %8.2f allocs/op %9.1f MB"
+                " heap %8.1f MB rss",
+                r.name.c_str(), r.seconds * 1e9 / ops, ops / r.seconds / 1e6,
+                static_cast<double>(r.allocations) / ops,
+                static_cast<double>(r.peak_heap) / 1e6,
+                static_cast<double>(r.peak_rss_kb) / 1e3);
+    for (const auto &m : r.metrics)
+      std::printf(" %s=%g", m.first.c_str(), m.second);
+    std::printf("\n");
+  }
+
+  void flush() {
+    for (; printed_ < results_.size(); ++printed_)
+      print(results_[printed_]);
+  }
+
+  static std::string quote(const std::string &s) {
+    std::string q = "\"";
+    for (const auto c : s) {
+      if (c == '"' || c == '\\')
+        q += '\\';
+      q += c;
+    }
+    return q + '"';
+  }
+
+  void write_json() const {
+    auto f = std::fopen(json_.c_str(), "w");
+    if (!f) {
+      std::fprintf(stderr, "%s: cannot write %s\n", name_.c_str(),
+                   json_.c_str());
+      return;
+    }
+    std::fprintf(f, "{\n  \"benchmark\": %s,\n  \"repeat\": %zu,\n",
+                 quote(name_).c_str(), repeat_);
+    std::fprintf(f, "  \"scale\": %s,\n  \"results\": [",
+                 scale_ == 1 ? "\"full\"" : "\"quick\"");
+    for (size_t i = 0; i < results_.size(); ++i) {
+      const auto &r = results_[i];
+      const auto ops = static_cast<double>(std::max<size_t>(r.ops, 1));
+      std::fprintf(f,
+                   "%s\n    {\"name\": %s, \"ops\": %zu, \"seconds\": %.9g, "
+                   "\"ns_per_op\": %.6g, \"ops_per_sec\": %.6g, "
+                   "\"allocations\": %zu, \"allocated_bytes\": %zu, "
+                   "\"peak_heap_bytes\": %zu, \"peak_rss_kb\": %ld",
+                   i ? "," : "", quote(r.name).c_str(), r.ops, r.seconds,
+                   r.seconds * 1e9 / ops, ops / r.seconds, r.allocations,
+                   r.allocated, r.peak_heap, r.peak_rss_kb);
+      if (!r.metrics.empty()) {
+        std::fprintf(f, ", \"metrics\": {");
+        for (size_t j = 0; j < r.metrics.size(); ++j)
+          if (std::isfinite(r.metrics[j].second))
+            std::fprintf(f, "%s%s: %.6g", j ? ", " : "",
+                         quote(r.metrics[j].first).c_str(),
+                         r.metrics[j].second);
+          else
+            std::fprintf(f, "%s%s: null", j ? ", " : "",
+                         quote(r.metrics[j].first).c_str());
+        std::fprintf(f, "}");
+      }
+      std::fprintf(f, "}");
+    }
+    std::fprintf(f, "\n  ]\n}\n");
+    std::fclose(f);
+  }
+
+public:
+  /**
+   * Parse the common options.
+   * @param name Name of the benchmark program
+   */
+  benchmark_suite(const char *name, int argc, char **argv) : name_(name) {
+    for (int i = 1; i < argc; ++i) {
+      const std::string a = argv[i];
+      if (a == "--json" && i + 1 < argc)
+        json_ = argv[++i];
+      else if (a == "--repeat" && i + 1 < argc)
+        repeat_ = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+      else if (a == "--filter" && i + 1 < argc)
+        filter_ = argv[++i];
+      else if (a == "--quick")
+        scale_ = 100;
+      else
+        args_.push_back(a);
+    }
+  }
+
+  benchmark_suite(const benchmark_suite &) = delete;
+  benchmark_suite &operator=(const benchmark_suite &) = delete;
+
+  /**
+   * Print what is left and write the JSON file, if one was requested.
+   */
+  ~benchmark_suite() {
+    flush();
+    if (!json_.empty())
+      write_json();
+  }
+
+  /**
+   * Get a positional argument.
+   * @param  i   Index among the positional arguments
+   * @param  def Value if it was not given
+   * @return     The argument
+   */
+  size_t arg(size_t i, size_t def) const {
+    return i < args_.size() ? std::strtoul(args_[i].c_str(), nullptr, 10)
+                            : def;
+  }
+
+  /**
+   * Scale a problem size by the --quick option.
+   * @param  n Full problem size
+   * @return   Size to use, at least 1
+   */
+  size_t size(size_t n) const { return std::max<size_t>(n / scale_, 1); }
+
+  /**
+   * Keep a value from being optimized away.
+   */
+  template <class T> static void keep(const T &value) {
+    asm volatile("" : : "g"(&value) : "memory");
+  }
+
+  /**
+   * Time a case. setup() runs before each repetition, untimed, and its
+   * return value is passed to f, which is timed.
+   * @param  name  Case name
+   * @param  ops   Number of operations f performs, for the per-op figures
+   * @param  setup Called as setup() to build the input
+   * @param  f     Called as f(input); any return value is kept
+   * @return       The result, for attaching metrics until the next run
+   */
+  template <class Setup, class F>
+  result &run(const std::string &name, size_t ops, Setup setup, F f) {
+    flush();
+    if (name.find(filter_) == std::string::npos)
+      return skipped_ = result();
+
+    auto &h = detail::heap();
+    result r;
+    r.name = name;
+    r.ops = ops;
+    for (size_t i = 0; i < repeat_; ++i) {
+      auto input = setup();
+      const auto allocations = h.allocations.load();
+      const auto allocated = h.allocated.load();
+      const auto live = h.live.load();
+      h.peak.store(live);
+
+      const auto start = std::chrono::steady_clock::now();
+      if constexpr (std::is_void<decltype(f(input))>::value)
+        f(input);
+      else
+        keep(f(input));
+      const auto sec = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+
+      if (i == 0 || sec < r.seconds)
+        r.seconds = sec;
+      r.allocations = h.allocations.load() - allocations;
+      r.allocated = h.allocated.load() - allocated;
+      r.peak_heap = h.peak.load() - live;
+    }
+    // A case faster than one clock tick would otherwise report infinite
+    // rates, which are not valid JSON
+    r.seconds = std::max(
+        r.seconds, std::chrono::duration<double>(
+                       std::chrono::steady_clock::duration(1)).count());
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    r.peak_rss_kb = usage.ru_maxrss;
+    results_.push_back(std::move(r));
+    return results_.back();
+  }
+
+  /**
+   * Time a case with no setup.
+   */
+  template <class F> result &run(const std::string &name, size_t ops, F f) {
+    return run(name, ops, [] { return 0; }, [&f](int) { return f(); });
+  }
+
+  /**
+   * Get the bytes currently held on the heap, for measuring footprints.
+   */
+  static size_t heap_bytes() { return detail::heap().live.load(); }
+};
@@ -0,0 +1,85 @@
+// Memory, lookup and iteration for compressed_flat_set against flat_set, on
+// id sets of different densities.
+//
+// Usage: compressed_flat_set_benchmark [largest size] [benchmark options]
+
+#include "benchmark.h"
+#include "compressed_flat_set.h"
+#include "flat_set.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+template <class Set>
+static void run(benchmark_suite &s, const string &name, const char *impl,
+                const vector<uint64_t> &ids, const vector<uint64_t> &queries,
+                Set (*build)(const vector<uint64_t> &)) {
+  s.run("build/" + name + impl, ids.size(),
+        [&] { return build(ids).size(); });
+
+  const auto before = benchmark_suite::heap_bytes();
+  const auto set = build(ids);
+  const auto bytes = benchmark_suite::heap_bytes() - before;
+
+  auto &r = s.run("find/" + name + impl, queries.size(), [&] {
+    size_t hits = 0;
+    for (const auto q : queries)
+      hits += set.find(q) != set.end();
+    return hits;
+  });
+  r.metric("bytes_per_id", static_cast<double>(bytes) / ids.size());
+  s.run("iterate/" + name + impl, ids.size(), [&] {
+    uint64_t sum = 0;
+    for (const auto k : set)
+      sum += k;
+    return sum;
+  });
+}
+
+static flat_set<uint64_t> build_flat(const vector<uint64_t> &ids) {
+  flat_set<uint64_t> set;
+  for (const auto k : ids)
+    set.insert(k);
+  return set;
+}
+
+static compressed_flat_set<> build_compressed(const vector<uint64_t> &ids) {
+  return compressed_flat_set<>(ids.begin(), ids.end());
+}
+
+int main(int argc, char **argv) {
+  benchmark_suite s("compressed_flat_set", argc, argv);
+  const auto largest = s.size(s.arg(0, 10000000));
+
+  // Average gap between ids: dense ranges, sparse ids, and random 64-bit ids
+  for (const uint64_t spread : {2, 16, 0}) {
+    for (size_t n = 1000; n <= largest; n *= 10) {
+      mt19937_64 rng(4); // Consistent ids between runs
+      vector<uint64_t> ids(n);
+      if (spread) {
+        uint64_t x = 1 << 20;
+        for (auto &k : ids)
+          k = x += 1 + rng() % (2 * spread - 1);
+      } else {
+        ids = make_keys(distribution::uniform, n);
+        sort(ids.begin(), ids.end());
+      }
+
+      // Half of the queries are members
+      vector<uint64_t> queries(min<size_t>(n, 1000000));
+      for (size_t i = 0; i < queries.size(); ++i)
+        queries[i] = i % 2 ? ids[rng() % n] : ids[rng() % n] + 1;
+
+      const auto name =
+          (spread ? "gap" + to_string(spread) : string("random")) + "/" +
+          to_string(n) + "/";
+      run(s, name, "flat_set", ids, queries, build_flat);
+      run(s, name, "compressed_flat_set", ids, queries, build_compressed);
+    }
+  }
+}
@@ -0,0 +1,142 @@
+#include "compressed_flat_set.h"
+#define BOOST_TEST_MODULE compressed_flat_set_test
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace std;
+
+// Compare every operation against std::set
+template <class T>
+static void check_equal(const compressed_flat_set<T> &a, const set<T> &b) {
+  BOOST_REQUIRE_EQUAL(a.size(), b.size());
+  BOOST_REQUIRE(equal(a.begin(), a.end(), b.begin(), b.end()));
+}
+
+BOOST_AUTO_TEST_CASE(constructors_test) {
+  compressed_flat_set<> c1;
+  BOOST_CHECK_EQUAL(c1.size(), 0);
+  BOOST_CHECK(c1.empty());
+  BOOST_CHECK(c1.begin() == c1.end());
+  BOOST_CHECK(c1.find(0) == c1.end());
+  BOOST_CHECK(c1.lower_bound(5) == c1.end());
+
+  compressed_flat_set<> c2(c1);
+  BOOST_CHECK(c2.empty());
+
+  compressed_flat_set<> c3{5, 3, 3, 1};
+  BOOST_CHECK_EQUAL(c3.size(), 3);
+  BOOST_CHECK((vector<uint64_t>(c3.begin(), c3.end()) ==
+               vector<uint64_t>{1, 3, 5}));
+}
+
+BOOST_AUTO_TEST_CASE(bulk_test) {
+  mt19937_64 rng(4); // Consistent numbers for testing
+  for (const uint64_t spread : {1, 3, 100, 1000000}) {
+    vector<uint64_t> v(10000);
+    uint64_t x = 0;
+    for (auto &k : v)
+      k = x += 1 + rng() % spread;
+    shuffle(v.begin(), v.end(), rng);
+
+    const compressed_flat_set<> a(v.begin(), v.end());
+    const set<uint64_t> b(v.begin(), v.end());
+    check_equal(a, b);
+
+    for (size_t i = 0; i < 10000; ++i) {
+      const auto q = rng() % (x + 10);
+      const auto lb = a.lower_bound(q);
+      const auto expect = b.lower_bound(q);
+      BOOST_REQUIRE_EQUAL(lb == a.end(), expect == b.end());
+      if (lb != a.end())
+        BOOST_REQUIRE_EQUAL(*lb, *expect);
+      BOOST_REQUIRE_EQUAL(a.count(q), b.count(q));
+      const auto ub = a.upper_bound(q);
+      BOOST_REQUIRE_EQUAL(ub == a.end(), b.upper_bound(q) == b.end());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(extremes_test) {
+  const auto top = numeric_limits<uint64_t>::max();
+  compressed_flat_set<> a{0, 1, top - 1, top};
+  BOOST_CHECK_EQUAL(a.size(), 4);
+  BOOST_CHECK((vector<uint64_t>(a.begin(), a.end()) ==
+               vector<uint64_t>{0, 1, top - 1, top}));
+  BOOST_CHECK_EQUAL(*a.find(top), top);
+  BOOST_CHECK(a.find(top - 2) == a.end());
+  BOOST_CHECK_EQUAL(*a.lower_bound(2), top - 1);
+
+  compressed_flat_set<uint8_t> b;
+  for (int i = 255; i >= 0; i -= 3)
+    b.insert(static_cast<uint8_t>(i));
+  BOOST_CHECK_EQUAL(b.size(), 86);
+  BOOST_CHECK_EQUAL(*b.begin(), 0);
+  BOOST_CHECK(b.count(255));
+}
+
+BOOST_AUTO_TEST_CASE(insert_erase_test) {
+  mt19937_64 rng(4);
+  compressed_flat_set<uint32_t> a;
+  set<uint32_t> b;
+  for (size_t i = 0; i < 20000; ++i) {
+    const auto k = static_cast<uint32_t>(rng() % 5000 * (1 + rng() % 3));
+    if (rng() % 3) {
+      const auto r = a.insert(k);
+      BOOST_REQUIRE_EQUAL(r.second, b.insert(k).second);
+      BOOST_REQUIRE_EQUAL(*r.first, k);
+    } else {
+      BOOST_REQUIRE_EQUAL(a.erase(k), b.erase(k));
+    }
+    if (i % 1000 == 0)
+      check_equal(a, b);
+  }
+  check_equal(a, b);
+
+  // Erase everything, emptying blocks on the way
+  for (const auto k : vector<uint32_t>(b.begin(), b.end()))
+    BOOST_REQUIRE_EQUAL(a.erase(k), 1);
+  BOOST_CHECK(a.empty());
+  BOOST_CHECK(a.begin() == a.end());
+}
+
+BOOST_AUTO_TEST_CASE(iterator_test) {
+  compressed_flat_set<> a;
+  for (uint64_t i = 0; i < 1000; ++i)
+    a.insert(i * 7);
+  auto it = a.find(700);
+  BOOST_REQUIRE(it != a.end());
+  for (uint64_t i = 100; i < 1000; ++i, ++it)
+    BOOST_REQUIRE_EQUAL(*it, i * 7);
+  BOOST_CHECK(it == a.end());
+
+  const auto r = a.equal_range(14);
+  BOOST_CHECK_EQUAL(*r.first, 14);
+  BOOST_CHECK_EQUAL(*r.second, 21);
+}
+
+BOOST_AUTO_TEST_CASE(memory_test) {
+  // Consecutive ids only need the block headers
+  vector<uint64_t> v(1 << 20);
+  for (size_t i = 0; i < v.size(); ++i)
+    v[i] = 1000000 + i;
+  compressed_flat_set<> a(v.begin(), v.end());
+  BOOST_CHECK_LT(a.memory_usage(), v.size() / 4);
+
+  // One id in every 16 takes about 5 bits
+  for (size_t i = 0; i < v.size(); ++i)
+    v[i] = i * 16 + i % 7;
+  compressed_flat_set<> b(v.begin(), v.end());
+  BOOST_CHECK_LT(b.memory_usage(), v.size());
+
+  compressed_flat_set<> c;
+  swap(b, c);
+  BOOST_CHECK(b.empty());
+  BOOST_CHECK_EQUAL(c.size(), v.size());
+  BOOST_CHECK(equal(c.begin(), c.end(), v.begin(), v.end()));
+}
@@ -0,0 +1,121 @@
+// Mixed read/write scalability of concurrent_trie against trie guarded by a
+// reader-writer lock. Readers look up random keys while one writer inserts
+// and erases keys at a fixed rate.
+//
+// Usage: concurrent_trie_benchmark [max threads] [writes per second]
+//                                  [benchmark options]
+
+#include "benchmark.h"
+#include "concurrent_trie.h"
+#include "trie.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// trie behind a reader-writer lock, the setup concurrent_trie replaces
+class locked_trie {
+  trie t_;
+  mutable shared_mutex m_;
+
+public:
+  void insert(const string &s) {
+    unique_lock<shared_mutex> lock(m_);
+    t_.insert(s);
+  }
+  void erase(const string &s) {
+    unique_lock<shared_mutex> lock(m_);
+    t_.erase(s);
+  }
+  bool find(const string &s) const {
+    shared_lock<shared_mutex> lock(m_);
+    return t_.find(s);
+  }
+};
+
+static vector<string> make_routes(size_t n) {
+  mt19937_64 rng(4); // Consistent keys between runs
+  vector<string> keys(n);
+  for (auto &k : keys) {
+    k = "/api/v" + to_string(rng() % 4) + "/";
+    for (size_t i = 0, len = 4 + rng() % 12; i < len; ++i)
+      k += static_cast<char>('a' + rng() % 26);
+  }
+  return keys;
+}
+
+// Readers split a fixed number of lookups while one writer toggles the odd
+// keys at a fixed rate until they finish
+template <class Trie>
+static void run(benchmark_suite &s, const string &name, size_t threads,
+                size_t lookups, size_t writes_per_sec,
+                const vector<string> &keys) {
+  Trie t;
+  for (size_t i = 0; i < keys.size(); i += 2)
+    t.insert(keys[i]);
+
+  size_t writes = 0;
+  double sec = 0;
+  auto &r = s.run(name, lookups, [&] {
+    const auto start = chrono::steady_clock::now();
+    atomic<bool> done{false};
+    atomic<size_t> hits{0};
+    vector<thread> readers;
+    for (size_t id = 0; id < threads; ++id) {
+      readers.emplace_back([&, id] {
+        mt19937_64 rng(id);
+        size_t h = 0;
+        for (size_t i = 0; i < lookups / threads; ++i)
+          h += t.find(keys[rng() % keys.size()]);
+        hits += h;
+      });
+    }
+
+    writes = 0;
+    thread writer([&] {
+      const auto gap =
+          chrono::microseconds(1000000 / max<size_t>(writes_per_sec, 1));
+      for (size_t i = 1; !done; i += 2, ++writes) {
+        const auto &k = keys[i % keys.size()];
+        if ((i / keys.size()) % 2)
+          t.erase(k);
+        else
+          t.insert(k);
+        this_thread::sleep_for(gap);
+      }
+    });
+
+    for (auto &th : readers)
+      th.join();
+    done = true;
+    writer.join();
+    sec = chrono::duration<double>(chrono::steady_clock::now() - start)
+              .count();
+    return hits.load();
+  });
+  r.metric("writes_per_sec", static_cast<double>(writes) / sec);
+}
+
+int main(int argc, char **argv) {
+  benchmark_suite s("concurrent_trie", argc, argv);
+  const auto max_threads =
+      s.arg(0, max<size_t>(thread::hardware_concurrency(), 1));
+  const auto writes = s.arg(1, 10);
+  const auto lookups = s.size(2000000);
+  const auto keys = make_routes(100000);
+
+  for (size_t t = 1; t <= max_threads; t *= 2) {
+    const auto suffix = "/x" + to_string(t);
+    run<locked_trie>(s, "find/locked_trie" + suffix, t, lookups, writes,
+                     keys);
+    run<concurrent_trie>(s, "find/concurrent_trie" + suffix, t, lookups,
+                         writes, keys);
+  }
+}
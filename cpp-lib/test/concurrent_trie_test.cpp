@@ -0,0 +1,98 @@
+#include "concurrent_trie.h"
+#define BOOST_TEST_MODULE concurrent_trie_test
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+BOOST_AUTO_TEST_CASE(empty_test) {
+  concurrent_trie a;
+  BOOST_CHECK(a.empty());
+  BOOST_CHECK_EQUAL(false, a.find(""));
+  BOOST_CHECK_EQUAL(false, a.find("a"));
+  BOOST_CHECK_EQUAL(false, a.find("abc"));
+}
+
+BOOST_AUTO_TEST_CASE(insert_erase_test) {
+  concurrent_trie a;
+
+  BOOST_CHECK(a.insert(""));
+  BOOST_CHECK(a.insert("a"));
+  BOOST_CHECK(a.insert("abc"));
+  BOOST_CHECK(!a.insert("abc"));
+  BOOST_CHECK_EQUAL(a.size(), 3);
+
+  BOOST_CHECK_EQUAL(true, a.find(""));
+  BOOST_CHECK_EQUAL(true, a.find("a"));
+  BOOST_CHECK_EQUAL(false, a.find("ab"));
+  BOOST_CHECK_EQUAL(true, a.find("abc"));
+  BOOST_CHECK_EQUAL(a.count_prefix("a"), 2);
+  BOOST_CHECK_EQUAL(a.longest_prefix_match("abx"), 1);
+
+  BOOST_CHECK(a.erase("abc"));
+  BOOST_CHECK(!a.erase("abc"));
+  BOOST_CHECK_EQUAL(false, a.find("abc"));
+  BOOST_CHECK_EQUAL(true, a.find("a"));
+  BOOST_CHECK_EQUAL(a.count_prefix("ab"), 0);
+
+  BOOST_CHECK(a.erase(""));
+  BOOST_CHECK_EQUAL(false, a.find(""));
+  BOOST_CHECK_EQUAL(a.longest_prefix_match("abx"), 1);
+  BOOST_CHECK_EQUAL(a.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(for_each_prefix_test) {
+  concurrent_trie a;
+  for (const auto s : {"car", "cart", "cat", "ca", "dog", "", "c"})
+    a.insert(s);
+
+  vector<string> ca;
+  a.for_each_prefix("ca", [&](const string &s) { ca.push_back(s); });
+  BOOST_CHECK((ca == vector<string>{"ca", "car", "cart", "cat"}));
+
+  vector<string> all;
+  a.for_each_prefix("", [&](const string &s) { all.push_back(s); });
+  BOOST_CHECK_EQUAL(all.size(), 7);
+  BOOST_CHECK_EQUAL(all.front(), "");
+  BOOST_CHECK_EQUAL(all.back(), "dog");
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_test) {
+  const int N = 1000;
+  concurrent_trie a;
+
+  // Even keys are always present, odd keys come and go
+  for (int i = 0; i < N; i += 2)
+    a.insert("key" + to_string(i));
+
+  atomic<bool> done{false};
+  atomic<int> errors{0};
+  vector<thread> readers;
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&, t] {
+      for (int i = t; !done; i = (i + 7) % N) {
+        if (i % 2 == 0 && !a.find("key" + to_string(i)))
+          ++errors;
+        if (a.count_prefix("key") < N / 2)
+          ++errors;
+      }
+    });
+  }
+
+  for (int round = 0; round < 20; ++round) {
+    for (int i = 1; i < N; i += 2)
+      a.insert("key" + to_string(i));
+    for (int i = 1; i < N; i += 2)
+      a.erase("key" + to_string(i));
+  }
+  done = true;
+  for (auto &r : readers)
+    r.join();
+
+  BOOST_CHECK_EQUAL(errors, 0);
+  BOOST_CHECK_EQUAL(a.size(), N / 2);
+}
@@ -0,0 +1,108 @@
+// Throughput of concurrent_union_find as threads are added, on uniform random
+// and power-law edge streams, with the serial union_find as the baseline.
+//
+// Usage: concurrent_union_find_benchmark [elements] [edges] [max threads]
+//                                        [benchmark options]
+
+#include "benchmark.h"
+#include "concurrent_union_find.h"
+#include "union_find.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+typedef vector<pair<size_t, size_t>> edge_list;
+
+static edge_list uniform_edges(size_t n, size_t m) {
+  mt19937_64 rng(4); // Consistent edges between runs
+  edge_list edges(m);
+  for (auto &e : edges)
+    e = {rng() % n, rng() % n};
+  return edges;
+}
+
+// Endpoints drawn with probability proportional to 1/rank, so a few hub
+// elements take part in most edges. Ranks are shuffled onto element ids.
+static edge_list power_law_edges(size_t n, size_t m) {
+  mt19937_64 rng(4); // Consistent edges between runs
+  vector<size_t> id(n);
+  iota(id.begin(), id.end(), size_t(0));
+  shuffle(id.begin(), id.end(), rng);
+
+  uniform_real_distribution<double> u(0, 1);
+  const auto log_n = log(static_cast<double>(n));
+  const auto pick = [&] {
+    const auto r = static_cast<size_t>(exp(u(rng) * log_n)) - 1;
+    return id[min(r, n - 1)];
+  };
+  edge_list edges(m);
+  for (auto &e : edges)
+    e = {pick(), pick()};
+  return edges;
+}
+
+static void run(benchmark_suite &s, const char *name, size_t n,
+                const edge_list &edges, size_t max_threads) {
+  union_find serial(0);
+  s.run(string(name) + "/union_find", edges.size(),
+        [n] { return union_find(n); },
+        [&](union_find &uf) {
+          for (const auto &e : edges)
+            uf.unite(e.first, e.second);
+          serial = move(uf);
+        });
+
+  // Powers of two, then max_threads itself
+  vector<size_t> counts;
+  for (size_t t = 1; t < max_threads; t *= 2)
+    counts.push_back(t);
+  counts.push_back(max_threads);
+
+  for (const auto t : counts) {
+    unique_ptr<concurrent_union_find> last;
+    auto &r = s.run(
+        string(name) + "/concurrent_union_find/x" + to_string(t),
+        edges.size(), [&] { return make_unique<concurrent_union_find>(n); },
+        [&](unique_ptr<concurrent_union_find> &uf) {
+          vector<thread> threads;
+          for (size_t id = 0; id < t; ++id) {
+            threads.emplace_back([&, id] {
+              const auto lo = edges.size() * id / t;
+              const auto hi = edges.size() * (id + 1) / t;
+              for (auto i = lo; i < hi; ++i)
+                uf->unite(edges[i].first, edges[i].second);
+            });
+          }
+          for (auto &th : threads)
+            th.join();
+          last = move(uf);
+        });
+
+    // Same partition as the serial run
+    bool ok = true;
+    for (size_t i = 1; last && serial.size() == n && i < n && ok; ++i)
+      ok = last->find(i, i - 1) == serial.find(i, i - 1);
+    r.metric("mismatch", ok ? 0 : 1);
+  }
+}
+
+int main(int argc, char **argv) {
+  benchmark_suite s("concurrent_union_find", argc, argv);
+  const auto n = s.size(s.arg(0, 1 << 22));
+  const auto m = s.size(s.arg(1, 1 << 24));
+  const auto max_threads =
+      s.arg(2, max<size_t>(thread::hardware_concurrency(), 1));
+
+  printf("%zu elements, %zu edges\n", n, m);
+  run(s, "uniform", n, uniform_edges(n, m), max_threads);
+  run(s, "power-law", n, power_law_edges(n, m), max_threads);
+}
@@ -0,0 +1,76 @@
+#include "concurrent_union_find.h"
+#include "union_find.h"
+#define BOOST_TEST_MODULE concurrent_union_find_test
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+BOOST_AUTO_TEST_CASE(constructors_test) {
+  const auto N = 100;
+  concurrent_union_find a(N);
+  BOOST_CHECK_EQUAL(a.size(), N);
+
+  for (size_t i = 1; i < N; ++i) {
+    BOOST_CHECK_EQUAL(false, a.find(i, i - 1));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(unite_test) {
+  const auto N = 100;
+  concurrent_union_find a(N);
+
+  // Unite odds and evens together
+  for (size_t i = 2; i < N; ++i) {
+    BOOST_CHECK(a.unite(i, i - 2));
+  }
+  BOOST_CHECK(!a.unite(0, N - 2));
+
+  for (size_t i = 1; i < N; ++i) {
+    BOOST_CHECK(!a.find(i, i - 1));
+  }
+
+  for (size_t i = 2; i < N; i += 2) {
+    BOOST_CHECK(a.find(0, i));
+    BOOST_CHECK(a.find(1, i - 1));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(threaded_test) {
+  srand(4); // Consistent numbers for testing
+  const size_t N = 10000;
+  const size_t M = 8000;
+  vector<pair<size_t, size_t>> edges(M);
+  for (auto &e : edges)
+    e = {rand() % N, rand() % N};
+
+  union_find expect(N);
+  for (const auto &e : edges)
+    expect.unite(e.first, e.second);
+
+  // Every edge that joins two sets is counted by exactly one thread
+  const size_t T = 4;
+  concurrent_union_find a(N);
+  vector<size_t> joined(T);
+  vector<thread> threads;
+  for (size_t t = 0; t < T; ++t) {
+    threads.emplace_back([&, t] {
+      for (size_t i = t; i < M; i += T)
+        joined[t] += a.unite(edges[i].first, edges[i].second);
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+
+  size_t sets = 0;
+  for (size_t i = 0; i < N; ++i)
+    sets += a.root(i) == i;
+  BOOST_CHECK_EQUAL(sets + joined[0] + joined[1] + joined[2] + joined[3], N);
+
+  for (size_t i = 1; i < N; ++i)
+    BOOST_CHECK_EQUAL(a.find(i, i - 1), expect.find(i, i - 1));
+}
@@ -0,0 +1,62 @@
+#include "dynamic_connectivity.h"
+#include "union_find.h"
+#define BOOST_TEST_MODULE dynamic_connectivity_test
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+BOOST_AUTO_TEST_CASE(empty_test) {
+  dynamic_connectivity a(10);
+  BOOST_CHECK(a.solve().empty());
+}
+
+BOOST_AUTO_TEST_CASE(simple_test) {
+  dynamic_connectivity a(4);
+  a.query(0, 1);
+  a.add_edge(0, 1);
+  a.add_edge(1, 2);
+  a.query(0, 2);
+  BOOST_CHECK(a.remove_edge(1, 0));
+  BOOST_CHECK(!a.remove_edge(1, 0));
+  a.query(0, 2);
+  a.query(1, 2);
+  a.add_edge(2, 3);
+  a.add_edge(2, 3);
+  a.remove_edge(3, 2);
+  a.query(1, 3);
+
+  const vector<bool> expect{false, true, false, true, true};
+  BOOST_CHECK(a.solve() == expect);
+}
+
+BOOST_AUTO_TEST_CASE(random_test) {
+  srand(4); // Consistent numbers for testing
+  const size_t N = 30;
+  dynamic_connectivity a(N);
+  vector<pair<size_t, size_t>> live;
+  vector<bool> expect;
+
+  for (int i = 0; i < 3000; ++i) {
+    const auto op = rand() % 3;
+    if (op == 0 || live.empty()) {
+      live.emplace_back(rand() % N, rand() % N);
+      a.add_edge(live.back().first, live.back().second);
+    } else if (op == 1) {
+      const auto j = static_cast<size_t>(rand()) % live.size();
+      BOOST_CHECK(a.remove_edge(live[j].second, live[j].first));
+      live.erase(live.begin() + static_cast<long>(j));
+    } else {
+      const auto x = rand() % N, y = rand() % N;
+      a.query(x, y);
+      union_find uf(N);
+      for (const auto &e : live)
+        uf.unite(e.first, e.second);
+      expect.push_back(uf.find(x, y));
+    }
+  }
+  BOOST_CHECK(a.solve() == expect);
+}
@@ -0,0 +1,75 @@
+// Insert, lookup and iteration for flat_set against boost::container::flat_set
+// and std::set.
+//
+// Usage: flat_set_benchmark [largest size] [benchmark options]
+//
+// Inserting random keys one at a time is quadratic for the flat sets, so the
+// random insert cases stop at a tenth of the largest size.
+
+#include "benchmark.h"
+#include "flat_set.h"
+
+#include <algorithm>
+#include <boost/container/flat_set.hpp>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+template <class Set> static Set build(const vector<uint64_t> &keys) {
+  Set set;
+  for (const auto k : keys)
+    set.insert(k);
+  return set;
+}
+
+template <class Set>
+static void run(benchmark_suite &s, const string &name, const char *impl,
+                distribution d, const vector<uint64_t> &keys,
+                const vector<uint64_t> &queries, size_t insert_limit) {
+  if (keys.size() <= insert_limit || d != distribution::uniform)
+    s.run("insert/" + name + impl, keys.size(),
+          [&] { return build<Set>(keys).size(); });
+
+  const auto set = build<Set>(keys);
+  s.run("find/" + name + impl, queries.size(), [&] {
+    size_t hits = 0;
+    for (const auto q : queries)
+      hits += set.find(q) != set.end();
+    return hits;
+  });
+  s.run("iterate/" + name + impl, set.size(), [&] {
+    uint64_t sum = 0;
+    for (const auto k : set)
+      sum += k;
+    return sum;
+  });
+}
+
+int main(int argc, char **argv) {
+  benchmark_suite s("flat_set", argc, argv);
+  const auto largest = s.size(s.arg(0, 1000000));
+
+  for (const auto d : {distribution::uniform, distribution::sorted}) {
+    for (size_t n = 1000; n <= largest; n *= 10) {
+      // Members are even, so odd queries always miss
+      auto keys = make_keys(d, n);
+      for (auto &k : keys)
+        k *= 2;
+      auto queries = keys;
+      for (size_t i = 0; i < queries.size(); i += 2)
+        ++queries[i];
+      shuffle(queries.begin(), queries.end(), mt19937_64(4));
+
+      const auto name = string(to_string(d)) + "/" + to_string(n) + "/";
+      run<flat_set<uint64_t>>(s, name, "flat_set", d, keys, queries,
+                              largest / 10);
+      run<boost::container::flat_set<uint64_t>>(
+          s, name, "boost::flat_set", d, keys, queries, largest / 10);
+      run<set<uint64_t>>(s, name, "std::set", d, keys, queries, largest / 10);
+    }
+  }
+}
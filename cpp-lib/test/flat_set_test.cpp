@@ -2,6 +2,10 @@
 #define BOOST_TEST_MODULE flat_set_test
 #include <boost/test/unit_test.hpp>
 
+#include "arena.h"
+
+#include <algorithm>
+
 using namespace std;
 
 BOOST_AUTO_TEST_CASE(constructors_test) {
@@ -36,6 +40,35 @@ BOOST_AUTO_TEST_CASE(insert_test) {
   BOOST_CHECK_EQUAL(q.second, true);
 }
 
+BOOST_AUTO_TEST_CASE(unordered_insert_test) {
+  flat_set<int> a;
+  for (int i : {5, 1, 9, 3, 7, 1, 9})
+    BOOST_CHECK(*a.insert(i).first == i);
+  BOOST_CHECK_EQUAL(a.size(), 5);
+  BOOST_CHECK(is_sorted(a.begin(), a.end()));
+  for (int i : {1, 3, 5, 7, 9})
+    BOOST_CHECK_EQUAL(a.count(i), 1);
+  BOOST_CHECK_EQUAL(a.count(4), 0);
+}
+
+BOOST_AUTO_TEST_CASE(move_swap_test) {
+  flat_set<int> a;
+  a.insert(1);
+  a.insert(2);
+
+  flat_set<int> b(std::move(a));
+  BOOST_CHECK_EQUAL(b.size(), 2);
+  BOOST_CHECK(a.empty());
+
+  a.insert(3);
+  a.swap(b);
+  BOOST_CHECK_EQUAL(a.size(), 2);
+  BOOST_CHECK_EQUAL(b.size(), 1);
+  swap(a, b);
+  BOOST_CHECK_EQUAL(a.count(3), 1);
+  BOOST_CHECK_EQUAL(b.count(1), 1);
+}
+
 BOOST_AUTO_TEST_CASE(operators_test) {
   flat_set<int> a;
   a.insert(1);
@@ -106,3 +139,23 @@ BOOST_AUTO_TEST_CASE(ranged_for_test) {
 
   BOOST_CHECK_EQUAL(cnt, 10);
 }
+
+BOOST_AUTO_TEST_CASE(allocator_test) {
+  arena r;
+  ::pmr::flat_set<int> a(&r);
+  for (int i = 9; i >= 0; --i)
+    a.insert(i);
+  BOOST_CHECK_GT(r.used(), 0);
+  BOOST_CHECK(a.get_allocator().resource() == &r);
+
+  // Copies keep the default resource unless given one
+  ::pmr::flat_set<int> b(a);
+  BOOST_CHECK(b.get_allocator().resource() != &r);
+  ::pmr::flat_set<int> c(a, &r);
+  BOOST_CHECK(c.get_allocator().resource() == &r);
+  BOOST_CHECK(std::equal(a.begin(), a.end(), c.begin(), c.end()));
+
+  ::pmr::flat_set<int> d(std::move(c), &r);
+  BOOST_CHECK_EQUAL(d.size(), 10);
+  BOOST_CHECK_EQUAL(*d.begin(), 0);
+}
@@ -0,0 +1,42 @@
+// Pushes then pops every key through heap and std::priority_queue.
+//
+// Usage: heap_benchmark [largest size] [benchmark options]
+
+#include "benchmark.h"
+#include "heap.h"
+
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+template <class Heap> static uint64_t push_pop(const vector<uint64_t> &keys) {
+  Heap h;
+  for (const auto k : keys)
+    h.push(k);
+  uint64_t sum = 0;
+  while (!h.empty()) {
+    sum = sum * 31 + h.top();
+    h.pop();
+  }
+  return sum;
+}
+
+int main(int argc, char **argv) {
+  benchmark_suite s("heap", argc, argv);
+  const auto largest = s.size(s.arg(0, 1000000));
+
+  for (const auto d : {distribution::uniform, distribution::sorted,
+                       distribution::reversed, distribution::few_unique}) {
+    for (size_t n = 1000; n <= largest; n *= 10) {
+      const auto keys = make_keys(d, n);
+      const auto name =
+          string("push_pop/") + to_string(d) + "/" + to_string(n) + "/";
+      s.run(name + "heap", n, [&] { return push_pop<heap<uint64_t>>(keys); });
+      s.run(name + "std::priority_queue", n,
+            [&] { return push_pop<priority_queue<uint64_t>>(keys); });
+    }
+  }
+}
@@ -0,0 +1,36 @@
+// Sorts keys with heap_sort, std::sort and std::make_heap + std::sort_heap.
+//
+// Usage: heap_sort_benchmark [largest size] [benchmark options]
+
+#include "benchmark.h"
+#include "heap_sort.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, char **argv) {
+  benchmark_suite s("heap_sort", argc, argv);
+  const auto largest = s.size(s.arg(0, 1000000));
+
+  for (const auto d : {distribution::uniform, distribution::sorted,
+                       distribution::reversed, distribution::few_unique}) {
+    for (size_t n = 1000; n <= largest; n *= 10) {
+      const auto keys = make_keys(d, n);
+      const auto copy = [&] { return keys; };
+      const auto name =
+          string("sort/") + to_string(d) + "/" + to_string(n) + "/";
+      s.run(name + "heap_sort", n, copy,
+            [](vector<uint64_t> &v) { heap_sort(v); });
+      s.run(name + "std::sort", n, copy,
+            [](vector<uint64_t> &v) { sort(v.begin(), v.end()); });
+      s.run(name + "std::sort_heap", n, copy, [](vector<uint64_t> &v) {
+        make_heap(v.begin(), v.end());
+        sort_heap(v.begin(), v.end());
+      });
+    }
+  }
+}
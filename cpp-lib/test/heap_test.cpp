@@ -3,6 +3,8 @@
 #include <boost/test/unit_test.hpp>
 #include <deque>
 
+#include "arena.h"
+
 using namespace std;
 
 BOOST_AUTO_TEST_CASE(constructors_test) {
@@ -71,3 +73,28 @@ BOOST_AUTO_TEST_CASE(swap_test) {
   BOOST_CHECK_EQUAL(b.top(), 1);
   BOOST_CHECK(a.empty());
 }
+
+BOOST_AUTO_TEST_CASE(allocator_test) {
+  arena r;
+  ::pmr::heap<int> a(&r);
+  for (int i = 0; i < 100; ++i)
+    a.push(i);
+  BOOST_CHECK_GT(r.used(), 0);
+
+  ::pmr::heap<int, std::greater<int>> b(std::greater<int>(), &r);
+  for (int i = 0; i < 100; ++i)
+    b.push(i);
+  BOOST_CHECK_EQUAL(a.top(), 99);
+  BOOST_CHECK_EQUAL(b.top(), 0);
+
+  ::pmr::heap<int> c(a, &r);
+  ::pmr::heap<int> d(std::move(a), &r);
+  BOOST_CHECK_EQUAL(c.size(), 100);
+  BOOST_CHECK_EQUAL(d.top(), 99);
+
+  // A heap of heaps passes its allocator down
+  std::pmr::vector<::pmr::heap<int>> v(&r);
+  v.emplace_back();
+  v.back().push(1);
+  BOOST_CHECK_EQUAL(v.back().top(), 1);
+}
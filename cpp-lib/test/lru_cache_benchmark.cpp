@@ -0,0 +1,65 @@
+// Cache lookups with insert on miss for lru_cache, on uniform and skewed
+// access patterns and a few capacities. An unbounded std::unordered_map does
+// the same work without eviction, as the baseline.
+//
+// Usage: lru_cache_benchmark [number of accesses] [benchmark options]
+
+#include "benchmark.h"
+#include "lru_cache.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, char **argv) {
+  benchmark_suite s("lru_cache", argc, argv);
+  const auto n = s.size(s.arg(0, 1000000));
+
+  for (const auto d : {distribution::uniform, distribution::skewed}) {
+    // Keys come from a space a tenth the size of the access stream
+    auto keys = make_keys(d, n);
+    for (auto &k : keys)
+      k %= n / 10 + 1;
+
+    for (const size_t percent : {1, 10, 50}) {
+      const auto capacity = max<size_t>(n / 10 * percent / 100, 1);
+      size_t hits = 0;
+      s.run("access/" + string(to_string(d)) + "/" + to_string(percent) +
+                "%/lru_cache",
+            n,
+            [&] {
+              lru_cache<uint64_t, uint64_t> cache(capacity);
+              hits = 0;
+              uint64_t sum = 0;
+              for (const auto k : keys) {
+                if (cache.contains(k)) {
+                  sum += cache.get(k);
+                  ++hits;
+                } else {
+                  cache.insert(k, k);
+                }
+              }
+              return sum;
+            })
+          .metric("hit_rate",
+                  static_cast<double>(hits) / static_cast<double>(n));
+    }
+
+    s.run("access/" + string(to_string(d)) + "/unbounded/std::unordered_map",
+          n, [&] {
+            unordered_map<uint64_t, uint64_t> cache;
+            uint64_t sum = 0;
+            for (const auto k : keys) {
+              const auto it = cache.find(k);
+              if (it != cache.end())
+                sum += it->second;
+              else
+                cache.emplace(k, k);
+            }
+            return sum;
+          });
+  }
+}
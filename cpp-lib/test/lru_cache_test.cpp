@@ -2,6 +2,8 @@
 #define BOOST_TEST_MODULE lru_cache_test
 #include <boost/test/unit_test.hpp>
 
+#include "arena.h"
+
 using namespace std;
 
 BOOST_AUTO_TEST_CASE(constructors_test) {
@@ -76,3 +78,15 @@ BOOST_AUTO_TEST_CASE(reorder_test) {
     }
   }
 }
+
+BOOST_AUTO_TEST_CASE(allocator_test) {
+  arena r;
+  ::pmr::lru_cache<int, int> a(10, &r);
+  for (int i = 0; i < 100; ++i)
+    a.insert(i, i + 1);
+  BOOST_CHECK_GT(r.used(), 0);
+  BOOST_CHECK(a.get_allocator().resource() == &r);
+  BOOST_CHECK_EQUAL(a.size(), 10);
+  BOOST_CHECK_EQUAL(a.get(99), 100);
+  BOOST_CHECK(!a.contains(89));
+}
@@ -0,0 +1,70 @@
+// Time to compute a minimum spanning forest of a random weighted graph with
+// Borůvka and filter-Kruskal as threads are added, with a sort-everything
+// Kruskal as the baseline.
+//
+// Usage: minimum_spanning_forest_benchmark [vertices] [edges] [max threads]
+//                                          [benchmark options]
+
+#include "benchmark.h"
+#include "minimum_spanning_forest.h"
+#include "union_find.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, char **argv) {
+  benchmark_suite s("minimum_spanning_forest", argc, argv);
+  const auto n = s.size(s.arg(0, 1 << 20));
+  const auto m = s.size(s.arg(1, 1 << 23));
+  const auto max_threads =
+      s.arg(2, max<size_t>(thread::hardware_concurrency(), 1));
+
+  mt19937_64 rng(4); // Consistent graph between runs
+  adjacency_list<weighted> g(n);
+  for (size_t i = 0; i < m; ++i)
+    g.add_edge(rng() % n, rng() % n, static_cast<int>(rng() % 1000000));
+  printf("%zu vertices, %zu edges\n", n, m);
+
+  long long expect = 0;
+  s.run("sorted_kruskal", m, [&] {
+    vector<msf_edge> edges;
+    edges.reserve(m);
+    for (size_t v = 0; v < n; ++v)
+      for (const auto &e : g.neighbors(v))
+        edges.push_back({v, e.get_dest(), e.get_weight()});
+    sort(edges.begin(), edges.end(),
+         [](const msf_edge &x, const msf_edge &y) { return x.w < y.w; });
+    union_find uf(n);
+    expect = 0;
+    for (const auto &e : edges)
+      if (uf.unite(e.a, e.b))
+        expect += e.w;
+    return expect;
+  });
+
+  // Powers of two, then max_threads itself
+  vector<size_t> counts;
+  for (size_t t = 1; t < max_threads; t *= 2)
+    counts.push_back(t);
+  counts.push_back(max_threads);
+
+  const pair<const char *, msf_algorithm> algorithms[] = {
+      {"boruvka", msf_algorithm::boruvka},
+      {"filter_kruskal", msf_algorithm::filter_kruskal}};
+  for (const auto &alg : algorithms) {
+    for (const auto t : counts) {
+      long long weight = 0;
+      auto &r = s.run(string(alg.first) + "/x" + to_string(t), m, [&] {
+        weight = minimum_spanning_forest(g, alg.second, t).weight;
+        return weight;
+      });
+      r.metric("mismatch", weight == expect ? 0 : 1);
+    }
+  }
+}
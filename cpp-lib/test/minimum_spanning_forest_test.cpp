@@ -0,0 +1,124 @@
+#include "minimum_spanning_forest.h"
+#include "union_find.h"
+#define BOOST_TEST_MODULE minimum_spanning_forest_test
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+static const msf_algorithm algorithms[] = {msf_algorithm::boruvka,
+                                           msf_algorithm::filter_kruskal};
+
+// Plain Kruskal to check against
+static long long kruskal_weight(const adjacency_list<weighted> &g) {
+  vector<msf_edge> edges;
+  for (size_t v = 0; v < g.size(); ++v)
+    for (const auto &e : g.neighbors(v))
+      edges.push_back({v, e.get_dest(), e.get_weight()});
+  sort(edges.begin(), edges.end(),
+       [](const msf_edge &x, const msf_edge &y) { return x.w < y.w; });
+  union_find uf(g.size());
+  long long w = 0;
+  for (const auto &e : edges)
+    if (uf.unite(e.a, e.b))
+      w += e.w;
+  return w;
+}
+
+// Check the edges exist, form a forest spanning every component and add up
+static void check_forest(const adjacency_list<weighted> &g,
+                         const spanning_forest &f) {
+  union_find components(g.size());
+  for (size_t v = 0; v < g.size(); ++v)
+    for (const auto &e : g.neighbors(v))
+      components.unite(v, e.get_dest());
+
+  union_find uf(g.size());
+  long long w = 0;
+  for (const auto &e : f.edges) {
+    BOOST_CHECK(uf.unite(e.a, e.b));
+    const auto &n = g.neighbors(e.a);
+    const auto &r = g.neighbors(e.b);
+    BOOST_CHECK(any_of(n.begin(), n.end(),
+                       [&](const weighted &x) {
+                         return x.get_dest() == e.b && x.get_weight() == e.w;
+                       }) ||
+                any_of(r.begin(), r.end(), [&](const weighted &x) {
+                  return x.get_dest() == e.a && x.get_weight() == e.w;
+                }));
+    w += e.w;
+  }
+  BOOST_CHECK_EQUAL(uf.num_sets(), components.num_sets());
+  BOOST_CHECK_EQUAL(w, f.weight);
+}
+
+BOOST_AUTO_TEST_CASE(empty_test) {
+  adjacency_list<weighted> g(0);
+  for (const auto alg : algorithms) {
+    const auto f = minimum_spanning_forest(g, alg, 2);
+    BOOST_CHECK(f.edges.empty());
+    BOOST_CHECK_EQUAL(f.weight, 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(simple_test) {
+  adjacency_list<weighted> g(6);
+  g.add_edge(0, 1, 4);
+  g.add_edge(1, 2, 1);
+  g.add_edge(2, 0, 2);
+  g.add_edge(0, 0, -5); // Self loops are never chosen
+  g.add_edge(3, 4, -3);
+  g.add_edge(4, 3, 7);  // Same edge stored the other way round
+  g.add_edge(4, 3, -3); // Parallel edge with the same weight
+  // Vertex 5 is isolated
+
+  for (const auto alg : algorithms) {
+    for (size_t threads = 1; threads <= 4; ++threads) {
+      const auto f = minimum_spanning_forest(g, alg, threads);
+      BOOST_CHECK_EQUAL(f.edges.size(), 3);
+      BOOST_CHECK_EQUAL(f.weight, 0);
+      check_forest(g, f);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(equal_weights_test) {
+  // Every spanning tree of a complete graph is minimal here
+  const size_t N = 50;
+  adjacency_list<weighted> g(N);
+  for (size_t i = 0; i < N; ++i)
+    for (size_t j = 0; j < N; ++j)
+      if (i != j)
+        g.add_edge(i, j, 1);
+
+  for (const auto alg : algorithms) {
+    const auto f = minimum_spanning_forest(g, alg, 3);
+    BOOST_CHECK_EQUAL(f.edges.size(), N - 1);
+    BOOST_CHECK_EQUAL(f.weight, N - 1);
+    check_forest(g, f);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(random_test) {
+  srand(4); // Consistent numbers for testing
+  for (size_t N : {10, 100, 2000}) {
+    for (size_t M : {N / 2, N * 2, N * 10}) {
+      adjacency_list<weighted> g(N);
+      for (size_t i = 0; i < M; ++i)
+        g.add_edge(static_cast<size_t>(rand()) % N,
+                   static_cast<size_t>(rand()) % N, rand() % 200 - 50);
+      const auto expect = kruskal_weight(g);
+
+      for (const auto alg : algorithms) {
+        for (size_t threads : {1, 4}) {
+          const auto f = minimum_spanning_forest(g, alg, threads);
+          BOOST_CHECK_EQUAL(f.weight, expect);
+          check_forest(g, f);
+        }
+      }
+    }
+  }
+}
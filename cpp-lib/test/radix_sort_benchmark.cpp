@@ -0,0 +1,76 @@
+// Sorts integer and string keys with the radix sorts against std::sort,
+// std::stable_sort and heap_sort, and the threaded radix sort as threads are
+// added.
+//
+// Usage: radix_sort_benchmark [largest size] [max threads]
+//                             [benchmark options]
+
+#include "benchmark.h"
+#include "heap_sort.h"
+#include "radix_sort.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+template <class T>
+static void run_sorts(benchmark_suite &s, const string &name,
+                      const vector<T> &keys) {
+  const auto n = keys.size();
+  const auto copy = [&] { return keys; };
+  s.run(name + "radix_sort", n, copy, [](vector<T> &v) { radix_sort(v); });
+  s.run(name + "american_flag_sort", n, copy,
+        [](vector<T> &v) { american_flag_sort(v); });
+  s.run(name + "std::sort", n, copy,
+        [](vector<T> &v) { sort(v.begin(), v.end()); });
+  s.run(name + "std::stable_sort", n, copy,
+        [](vector<T> &v) { stable_sort(v.begin(), v.end()); });
+  if (n <= 1000000)
+    s.run(name + "heap_sort", n, copy, [](vector<T> &v) { heap_sort(v); });
+}
+
+int main(int argc, char **argv) {
+  benchmark_suite s("radix_sort", argc, argv);
+  const auto largest = s.size(s.arg(0, 10000000));
+  const auto max_threads =
+      s.arg(1, max<size_t>(thread::hardware_concurrency(), 1));
+
+  for (const auto d : {distribution::uniform, distribution::sorted,
+                       distribution::few_unique}) {
+    for (size_t n = 1000; n <= largest; n *= 10) {
+      const auto keys = make_keys(d, n);
+      const auto name = string(to_string(d)) + "/" + to_string(n) + "/";
+      run_sorts(s, "uint64/" + name, keys);
+      run_sorts(s, "uint32/" + name,
+                vector<uint32_t>(keys.begin(), keys.end()));
+    }
+  }
+
+  // Threads, on the largest uniform input
+  const auto keys = make_keys(distribution::uniform, largest);
+  for (size_t t = 1; t <= max_threads; t *= 2) {
+    s.run("threads/uint64/" + to_string(largest) + "/x" + to_string(t),
+          largest, [&] { return keys; },
+          [t](vector<uint64_t> &v) {
+            radix_sort(v, detail::radix_identity(), t);
+          });
+  }
+
+  for (size_t n = 1000; n <= largest / 10; n *= 10) {
+    vector<string> words(n);
+    const auto k = make_keys(distribution::uniform, n);
+    for (size_t i = 0; i < n; ++i)
+      words[i] = "/usr/share/" + to_string(k[i] % 1000) + "/" +
+                 to_string(k[i]);
+    const auto copy = [&] { return words; };
+    const auto name = "string/" + to_string(n) + "/";
+    s.run(name + "radix_sort", n, copy,
+          [](vector<string> &v) { radix_sort(v); });
+    s.run(name + "std::sort", n, copy,
+          [](vector<string> &v) { sort(v.begin(), v.end()); });
+  }
+}
@@ -0,0 +1,189 @@
+#include "radix_sort.h"
+#define BOOST_TEST_MODULE radix_sort_test
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Random values of T covering its whole range, or only a few distinct ones
+template <class T> static vector<T> random_values(size_t n, bool few = false) {
+  mt19937_64 rng(4); // Consistent numbers for testing
+  vector<T> v(n);
+  for (auto &x : v) {
+    const auto r = few ? rng() % 4 * 1000003 : rng();
+    memcpy(&x, &r, sizeof(x));
+  }
+  return v;
+}
+
+template <class T> static void check_sorts(const vector<T> &v) {
+  auto expect = v;
+  sort(expect.begin(), expect.end());
+
+  auto a = v;
+  radix_sort(a);
+  BOOST_CHECK(a == expect);
+
+  auto b = v;
+  american_flag_sort(b);
+  BOOST_CHECK(b == expect);
+
+  auto c = v;
+  radix_sort(c, detail::radix_identity(), 4);
+  BOOST_CHECK(c == expect);
+}
+
+BOOST_AUTO_TEST_CASE(empty_test) {
+  vector<int> v;
+  radix_sort(v);
+  american_flag_sort(v);
+  BOOST_CHECK(v.empty());
+
+  v = {1};
+  radix_sort(v);
+  american_flag_sort(v);
+  BOOST_CHECK_EQUAL(v[0], 1);
+}
+
+BOOST_AUTO_TEST_CASE(int_sort_test) {
+  for (const size_t n : {10, 1000, 300000}) {
+    check_sorts(random_values<uint64_t>(n));
+    check_sorts(random_values<uint32_t>(n));
+    check_sorts(random_values<int64_t>(n));
+    check_sorts(random_values<int32_t>(n));
+    check_sorts(random_values<int16_t>(n));
+    check_sorts(random_values<signed char>(n));
+    check_sorts(random_values<uint64_t>(n, true));
+  }
+
+  vector<int> v = {numeric_limits<int>::max(), -1, 0,
+                   numeric_limits<int>::min(), 1};
+  radix_sort(v);
+  BOOST_CHECK(is_sorted(v.begin(), v.end()));
+}
+
+BOOST_AUTO_TEST_CASE(float_sort_test) {
+  mt19937_64 rng(4);
+  normal_distribution<double> dist(0, 1e6);
+  vector<double> d(10000);
+  for (auto &x : d)
+    x = dist(rng);
+  d.push_back(0.0);
+  d.push_back(-numeric_limits<double>::infinity());
+  d.push_back(numeric_limits<double>::infinity());
+  d.push_back(numeric_limits<double>::lowest());
+  d.push_back(numeric_limits<double>::denorm_min());
+  check_sorts(d);
+
+  vector<float> f(d.begin(), d.end());
+  check_sorts(f);
+}
+
+BOOST_AUTO_TEST_CASE(trivial_pass_test) {
+  // Only the lowest and highest bytes differ
+  vector<uint64_t> v;
+  for (uint64_t i = 0; i < 10000; ++i)
+    v.push_back((i * 7919 % 256) | (i % 3) << 56 | 0x0000abcdef000000);
+  check_sorts(v);
+
+  // Every key equal
+  check_sorts(vector<uint32_t>(1000, 42));
+}
+
+BOOST_AUTO_TEST_CASE(large_test) {
+  // Large enough to stage the scatter through the per-bucket buffers
+  const auto n = detail::radix_stage + 1000;
+  check_sorts(random_values<uint32_t>(n));
+  check_sorts(random_values<uint64_t>(n, true));
+}
+
+BOOST_AUTO_TEST_CASE(key_test) {
+  struct record {
+    uint32_t key;
+    size_t index;
+  };
+  mt19937_64 rng(4);
+  vector<record> v(100000);
+  for (size_t i = 0; i < v.size(); ++i)
+    v[i] = {static_cast<uint32_t>(rng() % 1000), i};
+
+  // Stable, so equal keys keep their order
+  for (const size_t threads : {1, 4}) {
+    auto a = v;
+    radix_sort(a, [](const record &r) { return r.key; }, threads);
+    for (size_t i = 1; i < a.size(); ++i) {
+      BOOST_REQUIRE_LE(a[i - 1].key, a[i].key);
+      if (a[i - 1].key == a[i].key)
+        BOOST_REQUIRE_LT(a[i - 1].index, a[i].index);
+    }
+  }
+
+  auto b = v;
+  american_flag_sort(b, [](const record &r) { return r.key; });
+  BOOST_CHECK(is_sorted(b.begin(), b.end(), [](const record &x,
+                                               const record &y) {
+    return x.key < y.key;
+  }));
+
+  // Descending by negating the key
+  vector<int> c = {3, 1, 2};
+  radix_sort(c, [](int x) { return -x; });
+  BOOST_CHECK((c == vector<int>{3, 2, 1}));
+}
+
+BOOST_AUTO_TEST_CASE(iterator_test) {
+  auto v = random_values<uint32_t>(5000);
+  deque<uint32_t> d(v.begin(), v.end());
+  sort(v.begin() + 100, v.end() - 100);
+
+  radix_sort(d.begin() + 100, d.end() - 100);
+  BOOST_CHECK(equal(v.begin(), v.end(), d.begin(), d.end()));
+
+  d.assign(v.rbegin(), v.rend());
+  american_flag_sort(d.begin(), d.end());
+  BOOST_CHECK(is_sorted(d.begin(), d.end()));
+}
+
+BOOST_AUTO_TEST_CASE(string_sort_test) {
+  mt19937_64 rng(4);
+  vector<string> v;
+  for (size_t i = 0; i < 20000; ++i) {
+    string s(rng() % 12, 'a');
+    for (auto &c : s)
+      c = static_cast<char>(rng() % 4 ? 'a' + rng() % 3 : rng() % 256);
+    v.push_back(s);
+  }
+  v.push_back("");
+  v.push_back(string(1000, 'x'));
+  v.push_back(string(1000, 'x') + "y");
+  check_sorts(v);
+
+  // Records sorted by a string field
+  vector<pair<string, int>> p;
+  for (size_t i = 0; i < 1000; ++i)
+    p.emplace_back(v[i], static_cast<int>(i));
+  radix_sort(p, [](const pair<string, int> &x) -> const string & {
+    return x.first;
+  });
+  BOOST_CHECK(is_sorted(p.begin(), p.end(), [](const pair<string, int> &x,
+                                               const pair<string, int> &y) {
+    return x.first < y.first;
+  }));
+}
+
+BOOST_AUTO_TEST_CASE(nested_prefix_test) {
+  // Every key is a prefix of the next, so each digit splits off one key
+  vector<string> v;
+  for (size_t i = 1; i <= 3000; ++i)
+    v.push_back(string(i, 'a'));
+  shuffle(v.begin(), v.end(), mt19937_64(4));
+  check_sorts(v);
+}
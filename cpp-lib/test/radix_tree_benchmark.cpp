@@ -0,0 +1,91 @@
+// Compares memory use and lookup speed of radix_tree against trie on a
+// synthetic URL dictionary.
+//
+// Usage: radix_tree_benchmark [number of keys] [benchmark options]
+
+#include "benchmark.h"
+#include "radix_tree.h"
+#include "trie.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static vector<string> make_urls(size_t n) {
+  mt19937_64 rng(4); // Consistent keys between runs
+  const char *schemes[] = {"http://", "https://"};
+  const char *tlds[] = {".com/", ".org/", ".net/", ".io/"};
+  vector<string> hosts(n / 50 + 1);
+  for (auto &h : hosts) {
+    h = "www.";
+    for (size_t i = 0, len = 4 + rng() % 8; i < len; ++i)
+      h += static_cast<char>('a' + rng() % 26);
+    h += tlds[rng() % 4];
+  }
+
+  vector<string> urls(n);
+  for (auto &u : urls) {
+    u = schemes[rng() % 2] + hosts[rng() % hosts.size()];
+    for (size_t seg = 0, segs = 1 + rng() % 4; seg < segs; ++seg) {
+      for (size_t i = 0, len = 3 + rng() % 10; i < len; ++i)
+        u += static_cast<char>('a' + rng() % 26);
+      u += '/';
+    }
+  }
+  return urls;
+}
+
+template <class Container, class Insert, class Find>
+static void run(benchmark_suite &s, const char *name,
+                const vector<string> &keys, const vector<string> &queries,
+                Insert insert, Find find) {
+  const auto n = keys.size();
+  auto &r = s.run("insert/" + to_string(n) + "/" + name, n, [&] {
+    Container c;
+    for (const auto &k : keys)
+      insert(c, k);
+    return c.size();
+  });
+  r.metric("bytes_per_key",
+           static_cast<double>(r.peak_heap) / static_cast<double>(n));
+
+  Container c;
+  for (const auto &k : keys)
+    insert(c, k);
+  s.run("find/" + to_string(n) + "/" + name, queries.size(), [&] {
+    size_t hits = 0;
+    for (const auto &q : queries)
+      hits += find(c, q);
+    return hits;
+  });
+}
+
+int main(int argc, char **argv) {
+  benchmark_suite s("radix_tree", argc, argv);
+  const auto keys = make_urls(s.size(s.arg(0, 200000)));
+
+  // Half hits, half misses, in random order
+  auto queries = keys;
+  for (size_t i = 0; i < queries.size(); i += 2)
+    queries[i].back() = '#';
+  shuffle(queries.begin(), queries.end(), mt19937_64(4));
+
+  size_t key_bytes = 0;
+  for (const auto &k : keys)
+    key_bytes += k.size();
+  printf("%zu keys, %.1f bytes/key of raw key data\n", keys.size(),
+         static_cast<double>(key_bytes) / static_cast<double>(keys.size()));
+
+  run<trie>(
+      s, "trie", keys, queries, [](trie &t, const string &k) { t.insert(k); },
+      [](const trie &t, const string &k) { return t.find(k); });
+  run<radix_tree<int>>(
+      s, "radix_tree", keys, queries,
+      [](radix_tree<int> &t, const string &k) { t.insert(k, 1); },
+      [](const radix_tree<int> &t, const string &k) {
+        return t.find(k) != nullptr;
+      });
+}
@@ -0,0 +1,119 @@
+#include "radix_tree.h"
+#define BOOST_TEST_MODULE radix_tree_test
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <map>
+#include <string>
+
+using namespace std;
+
+BOOST_AUTO_TEST_CASE(empty_test) {
+  radix_tree<int> a;
+  BOOST_CHECK(a.empty());
+  BOOST_CHECK(a.find("") == nullptr);
+  BOOST_CHECK(a.find("a") == nullptr);
+  BOOST_CHECK(a.find("abc") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(insert_test) {
+  radix_tree<int> a;
+
+  // Empty string is not a special case
+  BOOST_CHECK(a.insert("", 1));
+  BOOST_CHECK_EQUAL(*a.find(""), 1);
+  BOOST_CHECK(a.find("a") == nullptr);
+
+  BOOST_CHECK(a.insert("abc", 3));
+  BOOST_CHECK(a.find("a") == nullptr);
+  BOOST_CHECK(a.find("ab") == nullptr);
+  BOOST_CHECK_EQUAL(*a.find("abc"), 3);
+  BOOST_CHECK(a.find("abcd") == nullptr);
+
+  // Split the compressed edge in the middle
+  BOOST_CHECK(a.insert("a", 2));
+  BOOST_CHECK(a.insert("abd", 4));
+  BOOST_CHECK_EQUAL(*a.find("a"), 2);
+  BOOST_CHECK(a.find("ab") == nullptr);
+  BOOST_CHECK_EQUAL(*a.find("abc"), 3);
+  BOOST_CHECK_EQUAL(*a.find("abd"), 4);
+
+  // Overwrite
+  BOOST_CHECK(!a.insert("abc", 5));
+  BOOST_CHECK_EQUAL(*a.find("abc"), 5);
+  BOOST_CHECK_EQUAL(a.size(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(erase_test) {
+  radix_tree<int> a;
+
+  a.insert("");
+  a.insert("a");
+  a.insert("abc");
+
+  BOOST_CHECK(a.contains("abc"));
+  BOOST_CHECK(a.erase("abc"));
+  BOOST_CHECK(!a.erase("abc"));
+
+  BOOST_CHECK(a.contains("a"));
+  BOOST_CHECK(!a.contains("ab"));
+  BOOST_CHECK(!a.contains("abc"));
+
+  BOOST_CHECK(a.erase(""));
+
+  BOOST_CHECK(!a.contains(""));
+  BOOST_CHECK(a.contains("a"));
+  BOOST_CHECK(!a.contains("abc"));
+
+  a.insert("abcd");
+
+  BOOST_CHECK(!a.contains(""));
+  BOOST_CHECK(a.contains("a"));
+  BOOST_CHECK(!a.contains("ab"));
+  BOOST_CHECK(!a.contains("abc"));
+  BOOST_CHECK(a.contains("abcd"));
+
+  // Removing the middle key merges the remaining path back together
+  BOOST_CHECK(a.erase("a"));
+  BOOST_CHECK(a.contains("abcd"));
+  BOOST_CHECK_EQUAL(a.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(node_growth_test) {
+  radix_tree<int> a;
+
+  // Fan out through every node size and back down again
+  for (int i = 0; i < 256; ++i)
+    a.insert(string("x") + static_cast<char>(i), i);
+  BOOST_CHECK_EQUAL(a.size(), 256);
+  for (int i = 0; i < 256; ++i)
+    BOOST_CHECK_EQUAL(*a.find(string("x") + static_cast<char>(i)), i);
+
+  for (int i = 255; i > 0; --i)
+    BOOST_CHECK(a.erase(string("x") + static_cast<char>(i)));
+  BOOST_CHECK_EQUAL(a.size(), 1);
+  BOOST_CHECK_EQUAL(*a.find(string("x") + '\0'), 0);
+  BOOST_CHECK(a.find("x") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(random_test) {
+  srand(4); // Consistent numbers for testing
+  radix_tree<int> a;
+  map<string, int> m;
+
+  for (int i = 0; i < 20000; ++i) {
+    string s(rand() % 8, 'a');
+    for (auto &c : s)
+      c = static_cast<char>('a' + rand() % 4);
+    if (rand() % 3) {
+      BOOST_CHECK_EQUAL(a.insert(s, i), m.count(s) == 0);
+      m[s] = i;
+    } else {
+      BOOST_CHECK_EQUAL(a.erase(s), m.erase(s) == 1);
+    }
+  }
+
+  BOOST_CHECK_EQUAL(a.size(), m.size());
+  for (const auto &p : m)
+    BOOST_CHECK_EQUAL(*a.find(p.first), p.second);
+}
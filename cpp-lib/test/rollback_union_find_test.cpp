@@ -0,0 +1,78 @@
+#include "rollback_union_find.h"
+#define BOOST_TEST_MODULE rollback_union_find_test
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_CASE(constructors_test) {
+  const auto N = 100;
+  rollback_union_find a(N);
+  BOOST_CHECK_EQUAL(a.size(), N);
+  BOOST_CHECK_EQUAL(a.num_sets(), N);
+
+  for (size_t i = 1; i < N; ++i) {
+    BOOST_CHECK_EQUAL(false, a.find(i, i - 1));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(unite_test) {
+  const auto N = 100;
+  rollback_union_find a(N);
+
+  // Unite odds and evens together
+  for (size_t i = 2; i < N; ++i) {
+    a.unite(i, i - 2);
+  }
+
+  for (size_t i = 1; i < N; ++i) {
+    BOOST_CHECK(!a.find(i, i - 1));
+  }
+
+  for (size_t i = 2; i < N; i += 2) {
+    BOOST_CHECK(a.find(0, i));
+    BOOST_CHECK(a.find(1, i - 1));
+  }
+  BOOST_CHECK_EQUAL(a.num_sets(), 2);
+  BOOST_CHECK_EQUAL(a.set_size(0), N / 2);
+}
+
+BOOST_AUTO_TEST_CASE(rollback_test) {
+  const auto N = 10;
+  rollback_union_find a(N);
+
+  a.unite(0, 1);
+  const auto first = a.checkpoint();
+
+  a.unite(2, 3);
+  a.unite(1, 3);
+  BOOST_CHECK(!a.unite(0, 2)); // Failed unites are not logged
+  const auto second = a.checkpoint();
+  a.unite(4, 5);
+  BOOST_CHECK(a.find(0, 3));
+  BOOST_CHECK_EQUAL(a.set_size(0), 4);
+  BOOST_CHECK_EQUAL(a.num_sets(), N - 4);
+
+  a.rollback(second);
+  BOOST_CHECK(!a.find(4, 5));
+  BOOST_CHECK(a.find(0, 3));
+
+  a.rollback(first);
+  BOOST_CHECK(a.find(0, 1));
+  BOOST_CHECK(!a.find(0, 2));
+  BOOST_CHECK(!a.find(2, 3));
+  BOOST_CHECK_EQUAL(a.set_size(0), 2);
+  BOOST_CHECK_EQUAL(a.set_size(3), 1);
+  BOOST_CHECK_EQUAL(a.num_sets(), N - 1);
+
+  a.rollback(0);
+  for (size_t i = 0; i < N; ++i)
+    BOOST_CHECK_EQUAL(a.set_size(i), 1);
+}
+
+BOOST_AUTO_TEST_CASE(max_size_test) {
+  BOOST_CHECK_EQUAL(rollback_union_find::max_size(), 2147483647u);
+  // Checked before anything is allocated
+  BOOST_CHECK_THROW(rollback_union_find(rollback_union_find::max_size() + 1),
+                    length_error);
+  BOOST_CHECK_THROW(rollback_union_find(~size_t(0)), length_error);
+}
@@ -0,0 +1,149 @@
+#include "static_trie.h"
+#define BOOST_TEST_MODULE static_trie_test
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Check every query against the mutable trie it was built from
+static void check_same(const trie &a, const static_trie &b,
+                       const vector<string> &queries) {
+  BOOST_CHECK_EQUAL(a.size(), b.size());
+  BOOST_CHECK(vector<string>(a.begin(), a.end()) ==
+              vector<string>(b.begin(), b.end()));
+  for (const auto &q : queries) {
+    BOOST_CHECK_EQUAL(a.find(q), b.find(q));
+    BOOST_CHECK_EQUAL(a.count_prefix(q), b.count_prefix(q));
+    BOOST_CHECK_EQUAL(a.longest_prefix_match(q), b.longest_prefix_match(q));
+    const auto ra = a.starts_with(q);
+    const auto rb = b.starts_with(q);
+    BOOST_CHECK(vector<string>(ra.begin(), ra.end()) ==
+                vector<string>(rb.begin(), rb.end()));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(empty_test) {
+  trie a;
+  const auto b = freeze(a);
+  BOOST_CHECK(b.empty());
+  BOOST_CHECK_EQUAL(false, b.find(""));
+  BOOST_CHECK_EQUAL(false, b.find("a"));
+  BOOST_CHECK(b.begin() == b.end());
+  check_same(a, b, {"", "a", "abc"});
+}
+
+BOOST_AUTO_TEST_CASE(freeze_test) {
+  trie a;
+  for (const auto s : {"", "a", "abc", "abd", "b", "ba", "\xff"})
+    a.insert(s);
+  const auto b = freeze(a);
+
+  BOOST_CHECK_EQUAL(true, b.find(""));
+  BOOST_CHECK_EQUAL(true, b.find("a"));
+  BOOST_CHECK_EQUAL(false, b.find("ab"));
+  BOOST_CHECK_EQUAL(true, b.find("abc"));
+  BOOST_CHECK_EQUAL(false, b.find("abcd"));
+  BOOST_CHECK_EQUAL(b.count_prefix("ab"), 2);
+  check_same(a, b, {"", "a", "ab", "abc", "abcd", "b", "c", "\xff"});
+}
+
+BOOST_AUTO_TEST_CASE(random_test) {
+  srand(4); // Consistent numbers for testing
+  trie a;
+  vector<string> queries;
+  for (int i = 0; i < 20000; ++i) {
+    string s(rand() % 10, 'a');
+    for (auto &c : s)
+      c = static_cast<char>('a' + rand() % 5);
+    a.insert(s);
+    if (i % 10 == 0)
+      queries.push_back(s.substr(0, s.size() / 2));
+    if (i % 10 == 1)
+      queries.push_back(s + "e");
+  }
+  const auto b = freeze(a);
+  check_same(a, b, queries);
+}
+
+BOOST_AUTO_TEST_CASE(mmap_test) {
+  srand(4); // Consistent numbers for testing
+  trie a;
+  vector<string> queries;
+  for (int i = 0; i < 5000; ++i) {
+    string s(1 + rand() % 12, 'a');
+    for (auto &c : s)
+      c = static_cast<char>(rand() % 256);
+    a.insert(s);
+    queries.push_back(s.substr(0, s.size() - 1));
+  }
+
+  const string path = "static_trie_test.bin";
+  freeze(a).save(path);
+  {
+    auto b = static_trie::open(path);
+    check_same(a, b, queries);
+
+    // Moving keeps the mapping alive
+    auto c = std::move(b);
+    check_same(a, c, queries);
+  }
+  remove(path.c_str());
+
+  BOOST_CHECK_THROW(static_trie::open(path), runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(corrupt_test) {
+  trie a;
+  for (const auto s : {"a", "ab", "abc", "b", "ba", "cab"})
+    a.insert(s);
+  const string path = "static_trie_corrupt.bin";
+  freeze(a).save(path);
+
+  vector<uint64_t> good;
+  {
+    const auto f = fopen(path.c_str(), "rb");
+    uint64_t w;
+    while (fread(&w, sizeof(w), 1, f) == 1)
+      good.push_back(w);
+    fclose(f);
+  }
+  const auto write = [&](const vector<uint64_t> &v) {
+    const auto f = fopen(path.c_str(), "wb");
+    fwrite(v.data(), sizeof(uint64_t), v.size(), f);
+    fclose(f);
+  };
+
+  // Words 0 to 2 are the header, the LOUDS bits start at word 3
+  auto v = good;
+  v.pop_back();
+  write(v);
+  BOOST_CHECK_THROW(static_trie::open(path), runtime_error);
+
+  v = good;
+  v[1] = uint64_t(1) << 63; // Node count that overflows the layout
+  write(v);
+  BOOST_CHECK_THROW(static_trie::open(path), runtime_error);
+
+  v = good;
+  v[3] &= ~uint64_t(1); // No superroot
+  write(v);
+  BOOST_CHECK_THROW(static_trie::open(path), runtime_error);
+
+  v = good;
+  v[3] ^= uint64_t(1) << 5; // Popcount no longer matches the node count
+  write(v);
+  BOOST_CHECK_THROW(static_trie::open(path), runtime_error);
+
+  v = good;
+  v[3] ^= uint64_t(0x24); // Same popcount, but node 1 becomes its own child
+  write(v);
+  BOOST_CHECK_THROW(static_trie::open(path), runtime_error);
+
+  write(good);
+  check_same(a, static_trie::open(path), {"a", "ab", "c", "ca"});
+  remove(path.c_str());
+}
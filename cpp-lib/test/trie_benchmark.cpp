@@ -0,0 +1,113 @@
+// Insert, lookup and prefix counting for trie against std::set and
+// std::unordered_set of strings.
+//
+// Usage: trie_benchmark [largest number of words] [benchmark options]
+
+#include "benchmark.h"
+#include "trie.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+// Random lowercase words, or paths sharing long prefixes
+static vector<string> make_words(size_t n, bool paths) {
+  mt19937_64 rng(4); // Consistent words between runs
+  vector<string> dirs(n / 100 + 1);
+  for (auto &d : dirs) {
+    d = "/usr/";
+    for (size_t i = 0, len = 3 + rng() % 6; i < len; ++i)
+      d += static_cast<char>('a' + rng() % 26);
+    d += '/';
+  }
+  vector<string> words(n);
+  for (auto &w : words) {
+    if (paths)
+      w = dirs[rng() % dirs.size()];
+    for (size_t i = 0, len = 4 + rng() % 9; i < len; ++i)
+      w += static_cast<char>('a' + rng() % 26);
+  }
+  return words;
+}
+
+int main(int argc, char **argv) {
+  benchmark_suite s("trie", argc, argv);
+  const auto largest = s.size(s.arg(0, 100000));
+
+  for (const auto paths : {false, true}) {
+    for (size_t n = 1000; n <= largest; n *= 10) {
+      const auto words = make_words(n, paths);
+
+      // Half hits, half misses, in random order
+      auto queries = words;
+      for (size_t i = 0; i < queries.size(); i += 2)
+        queries[i].back() = '#';
+      shuffle(queries.begin(), queries.end(), mt19937_64(4));
+      vector<string> prefixes(queries.size());
+      for (size_t i = 0; i < queries.size(); ++i)
+        prefixes[i] = queries[i].substr(0, queries[i].size() / 2);
+
+      const auto name =
+          string(paths ? "paths/" : "words/") + to_string(n) + "/";
+
+      s.run("insert/" + name + "trie", n, [&] {
+        trie t;
+        for (const auto &w : words)
+          t.insert(w);
+        return t.size();
+      });
+      s.run("insert/" + name + "std::set", n, [&] {
+        return set<string>(words.begin(), words.end()).size();
+      });
+      s.run("insert/" + name + "std::unordered_set", n, [&] {
+        return unordered_set<string>(words.begin(), words.end()).size();
+      });
+
+      trie t;
+      for (const auto &w : words)
+        t.insert(w);
+      const set<string> ordered(words.begin(), words.end());
+      const unordered_set<string> hashed(words.begin(), words.end());
+
+      s.run("find/" + name + "trie", n, [&] {
+        size_t hits = 0;
+        for (const auto &q : queries)
+          hits += t.find(q);
+        return hits;
+      });
+      s.run("find/" + name + "std::set", n, [&] {
+        size_t hits = 0;
+        for (const auto &q : queries)
+          hits += ordered.count(q);
+        return hits;
+      });
+      s.run("find/" + name + "std::unordered_set", n, [&] {
+        size_t hits = 0;
+        for (const auto &q : queries)
+          hits += hashed.count(q);
+        return hits;
+      });
+
+      s.run("count_prefix/" + name + "trie", n, [&] {
+        size_t count = 0;
+        for (const auto &p : prefixes)
+          count += t.count_prefix(p);
+        return count;
+      });
+      s.run("count_prefix/" + name + "std::set", n, [&] {
+        size_t count = 0;
+        for (const auto &p : prefixes) {
+          for (auto it = ordered.lower_bound(p);
+               it != ordered.end() && it->compare(0, p.size(), p) == 0; ++it)
+            ++count;
+        }
+        return count;
+      });
+    }
+  }
+}
@@ -2,6 +2,15 @@
 #define BOOST_TEST_MODULE trie_test
 #include <boost/test/unit_test.hpp>
 
+#include "arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
 using namespace std;
 
 BOOST_AUTO_TEST_CASE(empty_test) {
@@ -62,3 +71,121 @@ BOOST_AUTO_TEST_CASE(erase_test) {
 
   BOOST_CHECK_EQUAL(true, a.find("abc"));
 }
+
+BOOST_AUTO_TEST_CASE(starts_with_test) {
+  trie a;
+  for (const auto s : {"car", "cart", "cat", "ca", "dog", "", "c"})
+    a.insert(s);
+  BOOST_CHECK_EQUAL(a.size(), 7);
+
+  const auto r = a.starts_with("ca");
+  const vector<string> ca(r.begin(), r.end());
+  BOOST_CHECK((ca == vector<string>{"ca", "car", "cart", "cat"}));
+
+  const vector<string> all(a.begin(), a.end());
+  BOOST_CHECK(
+      (all == vector<string>{"", "c", "ca", "car", "cart", "cat", "dog"}));
+
+  BOOST_CHECK(a.starts_with("x").empty());
+  BOOST_CHECK(a.starts_with("cb").empty());
+  BOOST_CHECK(!a.starts_with("cart").empty());
+
+  BOOST_CHECK_EQUAL(a.count_prefix(""), 7);
+  BOOST_CHECK_EQUAL(a.count_prefix("c"), 5);
+  BOOST_CHECK_EQUAL(a.count_prefix("car"), 2);
+  BOOST_CHECK_EQUAL(a.count_prefix("cx"), 0);
+
+  a.erase("car");
+  a.erase("car");
+  BOOST_CHECK_EQUAL(a.count_prefix("car"), 1);
+  BOOST_CHECK_EQUAL(a.size(), 6);
+}
+
+BOOST_AUTO_TEST_CASE(byte_order_test) {
+  trie a;
+  const vector<string> words{"a", string(1, '\x7f'), string(1, '\x80'),
+                             string(1, '\xff')};
+  for (const auto &s : words)
+    a.insert(s);
+
+  // Same order as std::string comparison
+  const vector<string> all(a.begin(), a.end());
+  BOOST_CHECK(all == words);
+}
+
+BOOST_AUTO_TEST_CASE(longest_prefix_match_test) {
+  trie a;
+  BOOST_CHECK_EQUAL(a.longest_prefix_match("10.0.1.5"), string::npos);
+
+  a.insert("10.");
+  a.insert("10.0.1.");
+  a.insert("192.168.");
+  BOOST_CHECK_EQUAL(a.longest_prefix_match("10.0.1.5"), 7);
+  BOOST_CHECK_EQUAL(a.longest_prefix_match("10.0.2.5"), 3);
+  BOOST_CHECK_EQUAL(a.longest_prefix_match("172.16.0.1"), string::npos);
+  BOOST_CHECK_EQUAL(a.longest_prefix_match("10"), string::npos);
+
+  a.insert("");
+  BOOST_CHECK_EQUAL(a.longest_prefix_match("172.16.0.1"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(top_k_test) {
+  srand(4); // Consistent numbers for testing
+  trie a;
+  map<string, double> m;
+  for (int i = 0; i < 5000; ++i) {
+    string s(1 + rand() % 6, 'a');
+    for (auto &c : s)
+      c = static_cast<char>('a' + rand() % 3);
+    const double score = rand() % 1000;
+    if (rand() % 4) {
+      a.insert(s, score);
+      m[s] = score;
+    } else {
+      a.erase(s);
+      m.erase(s);
+    }
+  }
+
+  for (const auto prefix : {"", "a", "ab", "cab", "zzz"}) {
+    vector<double> expect;
+    for (const auto &p : m)
+      if (p.first.compare(0, strlen(prefix), prefix) == 0)
+        expect.push_back(p.second);
+    sort(expect.rbegin(), expect.rend());
+    expect.resize(min<size_t>(expect.size(), 10));
+
+    const auto got = a.top_k(prefix, 10);
+    BOOST_REQUIRE_EQUAL(got.size(), expect.size());
+    for (size_t i = 0; i < got.size(); ++i) {
+      BOOST_CHECK_EQUAL(got[i].second, expect[i]);
+      BOOST_CHECK_EQUAL(m[got[i].first], got[i].second);
+      BOOST_CHECK_EQUAL(got[i].first.compare(0, strlen(prefix), prefix), 0);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(allocator_test) {
+  arena r;
+  ::pmr::trie a(&r);
+  a.insert("hello", 2);
+  a.insert("help", 3);
+  a.insert("world", 1);
+  BOOST_CHECK_GT(r.used(), 0);
+  BOOST_CHECK(a.get_allocator().resource() == &r);
+  BOOST_CHECK_EQUAL(a.size(), 3);
+  BOOST_CHECK(a.find("help"));
+  BOOST_CHECK_EQUAL(a.count_prefix("hel"), 2);
+  BOOST_CHECK_EQUAL(a.top_k("", 1)[0].first, "help");
+
+  a.erase("help");
+  BOOST_CHECK(!a.find("help"));
+  std::vector<std::string> words(a.begin(), a.end());
+  BOOST_CHECK_EQUAL(words.size(), 2);
+  BOOST_CHECK_EQUAL(words[0], "hello");
+
+  // Copies use the default resource, like the std::pmr containers
+  ::pmr::trie b(a);
+  BOOST_CHECK(b.get_allocator().resource() != &r);
+  BOOST_CHECK(b.find("world"));
+}
@@ -0,0 +1,71 @@
+// Unions then connectivity queries for union_find against
+// boost::disjoint_sets, on uniform and power-law edge streams.
+//
+// Usage: union_find_benchmark [largest number of elements] [benchmark options]
+
+#include "benchmark.h"
+#include "union_find.h"
+
+#include <boost/pending/disjoint_sets.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, char **argv) {
+  benchmark_suite s("union_find", argc, argv);
+  const auto largest = s.size(s.arg(0, 1000000));
+
+  for (const auto d : {distribution::uniform, distribution::skewed}) {
+    for (size_t n = 1000; n <= largest; n *= 10) {
+      // Edge endpoints, two per edge, four edges per element
+      auto ends = make_keys(d, 8 * n);
+      for (auto &e : ends)
+        e %= n;
+      if (d == distribution::skewed) {
+        // Spread the popular elements around
+        for (auto &e : ends)
+          e = e * 2654435761u % n;
+      }
+
+      const auto name = string(to_string(d)) + "/" + to_string(n) + "/";
+      s.run("unite/" + name + "union_find", 4 * n, [&] {
+        union_find uf(n);
+        for (size_t i = 0; i < ends.size(); i += 2)
+          uf.unite(ends[i], ends[i + 1]);
+        return uf.num_sets();
+      });
+      s.run("unite/" + name + "boost::disjoint_sets", 4 * n, [&] {
+        boost::disjoint_sets_with_storage<> ds(n);
+        for (size_t i = 0; i < n; ++i)
+          ds.make_set(i);
+        for (size_t i = 0; i < ends.size(); i += 2)
+          ds.union_set(ends[i], ends[i + 1]);
+        return ds.count_sets(ds.parents().begin(),
+                             ds.parents().begin() + static_cast<long>(n));
+      });
+
+      union_find uf(n);
+      boost::disjoint_sets_with_storage<> ds(n);
+      for (size_t i = 0; i < n; ++i)
+        ds.make_set(i);
+      for (size_t i = 0; i < ends.size() / 4; i += 2) {
+        uf.unite(ends[i], ends[i + 1]);
+        ds.union_set(ends[i], ends[i + 1]);
+      }
+      s.run("find/" + name + "union_find", 4 * n, [&] {
+        size_t same = 0;
+        for (size_t i = 0; i < ends.size(); i += 2)
+          same += uf.find(ends[i], ends[i + 1]);
+        return same;
+      });
+      s.run("find/" + name + "boost::disjoint_sets", 4 * n, [&] {
+        size_t same = 0;
+        for (size_t i = 0; i < ends.size(); i += 2)
+          same += ds.find_set(ends[i]) == ds.find_set(ends[i + 1]);
+        return same;
+      });
+    }
+  }
+}
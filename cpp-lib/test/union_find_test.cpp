@@ -32,3 +32,61 @@ BOOST_AUTO_TEST_CASE(unite_test) {
     BOOST_CHECK(a.find(1, i - 1));
   }
 }
+
+BOOST_AUTO_TEST_CASE(set_size_test) {
+  const auto N = 100;
+  union_find a(N);
+  BOOST_CHECK_EQUAL(a.num_sets(), N);
+
+  BOOST_CHECK(a.unite(0, 1));
+  BOOST_CHECK(a.unite(2, 3));
+  BOOST_CHECK(a.unite(1, 3));
+  BOOST_CHECK(!a.unite(0, 2));
+
+  BOOST_CHECK_EQUAL(a.num_sets(), N - 3);
+  for (size_t i = 0; i < 4; ++i)
+    BOOST_CHECK_EQUAL(a.set_size(i), 4);
+  BOOST_CHECK_EQUAL(a.set_size(4), 1);
+}
+
+BOOST_AUTO_TEST_CASE(add_test) {
+  union_find a(0);
+  a.reserve(10);
+  BOOST_CHECK_EQUAL(a.size(), 0);
+  BOOST_CHECK_EQUAL(a.num_sets(), 0);
+
+  for (size_t i = 0; i < 10; ++i)
+    BOOST_CHECK_EQUAL(a.add(), i);
+  BOOST_CHECK_EQUAL(a.size(), 10);
+  BOOST_CHECK_EQUAL(a.num_sets(), 10);
+
+  for (size_t i = 1; i < 10; ++i)
+    a.unite(i, i - 1);
+  const auto b = a.add();
+  BOOST_CHECK_EQUAL(a.num_sets(), 2);
+  BOOST_CHECK(!a.find(0, b));
+  a.unite(b, 0);
+  BOOST_CHECK_EQUAL(a.set_size(b), 11);
+}
+
+BOOST_AUTO_TEST_CASE(const_find_test) {
+  const auto N = 1000000;
+  union_find a(N);
+
+  // Merge equal sized sets to build trees of maximum height
+  for (size_t step = 1; step < N; step *= 2)
+    for (size_t i = 0; i + step < N; i += 2 * step)
+      a.unite(i + step, i);
+
+  const auto &c = a;
+  BOOST_CHECK(c.find(0, N - 1));
+  BOOST_CHECK_EQUAL(c.set_size(N / 2), N);
+  BOOST_CHECK_EQUAL(c.root(N - 1), a.root(N - 1));
+}
+
+BOOST_AUTO_TEST_CASE(max_size_test) {
+  BOOST_CHECK_EQUAL(union_find::max_size(), 2147483647u);
+  // Checked before anything is allocated
+  BOOST_CHECK_THROW(union_find(union_find::max_size() + 1), length_error);
+  BOOST_CHECK_THROW(union_find(~size_t(0)), length_error);
+}
@@ -1,52 +1,252 @@
 #pragma once
 
+#include <cstddef>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <memory_resource>
+#include <queue>
 #include <string>
+#include <utility>
+#include <vector>
 
 /**
  * Simple Trie container for storing and looking up string objects.
  *
  * This container is NOT compressed.
+ *
+ * Keys are kept in lexicographic order (the same order as std::string
+ * comparison) and may carry a score used to rank autocomplete results.
+ *
+ * Every node is allocated through the allocator, rebound to the node type.
+ * Use pmr::trie with an arena to build a trie cheaply and drop it at once.
  */
-class trie {
+template <class Allocator = std::allocator<char>> class basic_trie {
+  // Order children by unsigned byte value to match std::string ordering
+  struct byte_less {
+    bool operator()(char a, char b) const {
+      return static_cast<unsigned char>(a) < static_cast<unsigned char>(b);
+    }
+  };
+
+  struct Node;
+  typedef typename std::allocator_traits<Allocator>::template rebind_alloc<
+      std::pair<const char, Node>>
+      node_allocator;
+  typedef std::map<char, Node, byte_less, node_allocator> table_type;
+
   struct Node {
-    std::map<char, Node> table; // TODO: Replace with flat_map
+    table_type table; // TODO: Replace with flat_map
+    std::size_t count = 0; //!< Number of words in this subtree
+    double score = 0;      //!< Score of the word ending here
+    double best = 0;       //!< Highest score of any word in this subtree
     bool end = false;
+
+    explicit Node(const node_allocator &alloc) : table(alloc) {}
   };
   Node root;
 
+  /**
+   * Find the node reached by following a string from the root.
+   * @param  s String to follow
+   * @return   Node at the end of the path, or nullptr if there is none
+   */
+  const Node *find_node(const std::string &s) const {
+    auto ptr = &root;
+    for (const auto c : s) {
+      const auto it = ptr->table.find(c);
+      if (it == ptr->table.end()) {
+        return nullptr;
+      }
+      ptr = &it->second;
+    }
+    return ptr;
+  }
+
+  /**
+   * Recompute the highest score in a subtree from its direct children.
+   * @param ptr Node to update
+   */
+  static void update_best(Node *ptr) {
+    bool any = ptr->end;
+    auto best = ptr->score;
+    for (const auto &child : ptr->table) {
+      if (!any || child.second.best > best)
+        best = child.second.best;
+      any = true;
+    }
+    ptr->best = best;
+  }
+
+  /**
+   * Recursively lower the score of a word already in the trie.
+   * @param ptr   Pointer to current traversal node.
+   * @param s     Word to rescore.
+   * @param i     Iteration index.
+   * @param score New score.
+   */
+  void rescore(Node *ptr, const std::string &s, std::size_t i, double score) {
+    if (s.size() == i)
+      ptr->score = score;
+    else
+      rescore(&ptr->table.find(s[i])->second, s, i + 1, score);
+    update_best(ptr);
+  }
+
   /**
    * Recursively erase a word from the trie, freeing memory as we go
-   * @param ptr Pointer to current traversal node.
-   * @param s   Word to erase.
-   * @param i   Iteration index.
+   * @param  ptr Pointer to current traversal node.
+   * @param  s   Word to erase.
+   * @param  i   Iteration index.
+   * @return     True if the word was present.
    */
-  void erase(Node *ptr, const std::string &s, size_t i) {
+  bool erase(Node *ptr, const std::string &s, std::size_t i) {
     if (s.size() == i) {
+      if (!ptr->end)
+        return false;
       ptr->end = false;
     } else {
       const auto it = ptr->table.find(s.at(i));
       if (it == ptr->table.end()) {
-        return;
+        return false;
       }
       const auto next = &it->second;
-      erase(next, s, i + 1);
+      if (!erase(next, s, i + 1))
+        return false;
       // Erase the next node if it is empty
       if (!next->end && next->table.empty()) {
         ptr->table.erase(it);
       }
     }
+    --ptr->count;
+    update_best(ptr);
+    return true;
   }
 
 public:
   /**
-   * Insert a new string into the container.
-   * @param s String to insert
+   * Forward iterator over the words in a subtree, in lexicographic order.
+   * Words are produced lazily with a depth-first walk.
    */
-  void insert(const std::string &s) {
+  class const_iterator {
+    friend class basic_trie;
+
+    struct frame {
+      const Node *node;
+      typename table_type::const_iterator next;
+    };
+    std::vector<frame> stack_; //!< Path from the subtree root to the word
+    std::string key_;          //!< Word at the current position
+
+    const_iterator(const Node *ptr, std::string prefix)
+        : key_(std::move(prefix)) {
+      if (!ptr)
+        return;
+      stack_.push_back({ptr, ptr->table.begin()});
+      if (!ptr->end)
+        advance();
+    }
+
+    // Move to the next node marked as the end of a word
+    void advance() {
+      while (!stack_.empty()) {
+        auto &top = stack_.back();
+        if (top.next == top.node->table.end()) {
+          stack_.pop_back();
+          if (!stack_.empty())
+            key_.pop_back();
+          continue;
+        }
+        const auto &child = *top.next++;
+        key_.push_back(child.first);
+        stack_.push_back({&child.second, child.second.table.begin()});
+        if (child.second.end)
+          return;
+      }
+    }
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef std::string value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const std::string *pointer;
+    typedef const std::string &reference;
+
+    const_iterator() = default;
+
+    reference operator*() const { return key_; }
+    pointer operator->() const { return &key_; }
+
+    /**
+     * Score of the word at the current position.
+     */
+    double score() const { return stack_.back().node->score; }
+
+    const_iterator &operator++() {
+      advance();
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      auto tmp = *this;
+      advance();
+      return tmp;
+    }
+
+    friend bool operator==(const const_iterator &a, const const_iterator &b) {
+      if (a.stack_.empty() || b.stack_.empty())
+        return a.stack_.empty() == b.stack_.empty();
+      return a.stack_.back().node == b.stack_.back().node;
+    }
+
+    friend bool operator!=(const const_iterator &a, const const_iterator &b) {
+      return !(a == b);
+    }
+  };
+
+  /**
+   * Range of the words sharing a prefix, as returned by starts_with.
+   */
+  class prefix_range {
+    const_iterator first_;
+
+  public:
+    explicit prefix_range(const_iterator first) : first_(std::move(first)) {}
+    const_iterator begin() const { return first_; }
+    const_iterator end() const { return const_iterator(); }
+    bool empty() const { return first_ == const_iterator(); }
+  };
+
+  typedef Allocator allocator_type;
+
+  basic_trie() : basic_trie(Allocator()) {}
+
+  explicit basic_trie(const Allocator &alloc) : root(node_allocator(alloc)) {}
+
+  allocator_type get_allocator() const { return root.table.get_allocator(); }
+
+  /**
+   * Insert a new string into the container, or update its score.
+   * @param s     String to insert
+   * @param score Ranking used by top_k
+   */
+  void insert(const std::string &s, double score = 0) {
+    const auto old = find_node(s);
+    const bool added = !old || !old->end;
+    if (!added && score < old->score) {
+      rescore(&root, s, 0, score);
+      return;
+    }
     auto ptr = &root;
-    for (const auto c : s)
-      ptr = &ptr->table[c];
+    for (const auto c : s) {
+      ptr->best = ptr->count && ptr->best > score ? ptr->best : score;
+      ptr->count += added;
+      ptr = &ptr->table.try_emplace(c, ptr->table.get_allocator())
+                 .first->second;
+    }
+    ptr->best = ptr->count && ptr->best > score ? ptr->best : score;
+    ptr->count += added;
+    ptr->score = score;
     ptr->end = true;
   }
 
@@ -56,15 +256,8 @@ public:
    * @return   Returns true if found
    */
   bool find(const std::string &s) const {
-    auto ptr = &root;
-    for (const auto c : s) {
-      const auto it = ptr->table.find(c); // TODO: const auto
-      if (it == ptr->table.end()) {
-        return false;
-      }
-      ptr = &it->second;
-    }
-    return ptr->end;
+    const auto ptr = find_node(s);
+    return ptr && ptr->end;
   }
 
   /**
@@ -72,4 +265,109 @@ public:
    * @param s Word to remove
    */
   void erase(const std::string &s) { erase(&root, s, 0); }
+
+  /**
+   * Get number of words.
+   * @return Number of words in the trie
+   */
+  std::size_t size() const noexcept { return root.count; }
+
+  bool empty() const noexcept { return root.count == 0; }
+
+  const_iterator begin() const { return const_iterator(&root, std::string()); }
+  const_iterator end() const { return const_iterator(); }
+
+  /**
+   * Lazily enumerate every word beginning with a prefix.
+   * @param  prefix Prefix to search for
+   * @return        Range of matching words in lexicographic order
+   */
+  prefix_range starts_with(const std::string &prefix) const {
+    return prefix_range(const_iterator(find_node(prefix), prefix));
+  }
+
+  /**
+   * Count the words beginning with a prefix in O(prefix length).
+   * @param  prefix Prefix to search for
+   * @return        Number of matching words
+   */
+  std::size_t count_prefix(const std::string &prefix) const {
+    const auto ptr = find_node(prefix);
+    return ptr ? ptr->count : 0;
+  }
+
+  /**
+   * Find the longest word in the trie that is a prefix of a string.
+   * @param  s String to match against
+   * @return   Length of the longest matching word, or std::string::npos if no
+   *           word matches
+   */
+  std::size_t longest_prefix_match(const std::string &s) const {
+    auto ptr = &root;
+    auto match = ptr->end ? 0 : std::string::npos;
+    for (std::size_t i = 0; i < s.size(); ++i) {
+      const auto it = ptr->table.find(s[i]);
+      if (it == ptr->table.end())
+        break;
+      ptr = &it->second;
+      if (ptr->end)
+        match = i + 1;
+    }
+    return match;
+  }
+
+  /**
+   * Find the highest scoring words beginning with a prefix.
+   *
+   * Subtrees are expanded best-first using the highest score stored in each
+   * node, so only the paths leading to the results (and their siblings) are
+   * visited rather than every word under the prefix.
+   *
+   * @param  prefix Prefix to complete
+   * @param  k      Maximum number of results
+   * @return        Words and scores, highest score first
+   */
+  std::vector<std::pair<std::string, double>>
+  top_k(const std::string &prefix, std::size_t k) const {
+    struct entry {
+      double score;
+      const Node *node;
+      std::string key;
+      bool word; //!< Entry is the word ending at node, not its subtree
+    };
+    struct entry_less {
+      bool operator()(const entry &a, const entry &b) const {
+        if (a.score != b.score)
+          return a.score < b.score;
+        return a.word < b.word;
+      }
+    };
+
+    std::vector<std::pair<std::string, double>> result;
+    const auto start = find_node(prefix);
+    if (!start || !start->count || !k)
+      return result;
+
+    std::priority_queue<entry, std::vector<entry>, entry_less> pq;
+    pq.push({start->best, start, prefix, false});
+    while (!pq.empty() && result.size() < k) {
+      auto e = pq.top();
+      pq.pop();
+      if (e.word) {
+        result.emplace_back(std::move(e.key), e.score);
+        continue;
+      }
+      if (e.node->end)
+        pq.push({e.node->score, e.node, e.key, true});
+      for (const auto &child : e.node->table)
+        pq.push({child.second.best, &child.second, e.key + child.first, false});
+    }
+    return result;
+  }
 };
+
+typedef basic_trie<> trie;
+
+namespace pmr {
+typedef basic_trie<std::pmr::polymorphic_allocator<char>> trie;
+} // namespace pmr
@@ -1,52 +1,113 @@
-#include <numeric>
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
+namespace detail {
+
+/**
+ * Largest number of elements a union find packing parents and negated set
+ * sizes into std::int32_t entries can hold.
+ */
+constexpr std::size_t packed_forest_max_size() noexcept {
+  return std::numeric_limits<std::int32_t>::max();
+}
+
+/**
+ * Throw std::length_error if n elements do not fit a packed forest.
+ * @param  n    Number of elements
+ * @param  name Class name for the message
+ * @return      n
+ */
+inline std::size_t check_packed_forest_size(std::size_t n, const char *name) {
+  if (n > packed_forest_max_size())
+    throw std::length_error(std::string(name) +
+                            ": more than 2^31 - 1 elements");
+  return n;
+}
+
+} // namespace detail
+
 /**
  * Union Find data structure
  *
  * Generic implementation of the Weighted Quick Union Find data structure
+ *
+ * Parents and set sizes share one 32 bit entry per element: a root stores
+ * the negated size of its set, every other element stores its parent. This
+ * limits the structure to 2^31 - 1 elements; growing past that throws
+ * std::length_error.
  */
 class union_find {
   typedef std::size_t size_t;
 
-  std::vector<size_t> v;  //!< Root pointers
-  std::vector<size_t> sz; //!< Size of rooted tree
+  std::vector<std::int32_t> v; //!< Parent, or -size for roots
+  size_t sets = 0;             //!< Number of disjoint sets
+
+  static size_t check_size(size_t n) {
+    return detail::check_packed_forest_size(n, "union_find");
+  }
+
+public:
+  explicit union_find(size_t n) : v(check_size(n), -1), sets(n) {}
+
+  /**
+   * Get the largest number of elements the structure can hold.
+   */
+  static constexpr size_t max_size() noexcept {
+    return detail::packed_forest_max_size();
+  }
 
   /**
-   * Find root of set for the given element. Non-const so it squashes tree for
-   * faster future lookups.
+   * Find root of set for the given element. Non-const so it halves the path
+   * for faster future lookups.
    * @param  a Element to search for
    * @return   Root ID associated with input Element
    */
   size_t root(size_t a) {
-    if (v[a] != a)
-      v[a] = root(v[a]);
-    return v[a];
+    while (v[a] >= 0) {
+      const auto p = static_cast<size_t>(v[a]);
+      if (v[p] >= 0)
+        v[a] = v[p];
+      a = static_cast<size_t>(v[a]);
+    }
+    return a;
   }
 
-public:
-  explicit union_find(size_t n) : v(n), sz(n, 1) {
-    std::iota(v.begin(), v.end(), size_t(0));
+  /**
+   * Find root of set for the given element without modifying the structure.
+   * @param  a Element to search for
+   * @return   Root ID associated with input Element
+   */
+  size_t root(size_t a) const {
+    while (v[a] >= 0)
+      a = static_cast<size_t>(v[a]);
+    return a;
   }
 
   /**
    * Connect two elements. Connects the smaller tree under the bigger for a max
    * height of logN.
-   * @param a Element 1
-   * @param b Element 2
+   * @param  a Element 1
+   * @param  b Element 2
+   * @return   True if the elements were in different sets
    */
-  void unite(size_t a, size_t b) {
-    const auto rootA = root(a);
-    const auto rootB = root(b);
+  bool unite(size_t a, size_t b) {
+    auto rootA = root(a);
+    auto rootB = root(b);
     if (rootA == rootB)
-      return;
-    if (sz[rootA] > sz[rootB]) {
-      v[rootB] = rootA;
-      sz[rootA] += sz[rootB];
-    } else {
-      v[rootA] = rootB;
-      sz[rootB] += sz[rootA];
-    }
+      return false;
+    if (v[rootA] > v[rootB])
+      std::swap(rootA, rootB);
+    // rootA is now the bigger tree
+    v[rootA] += v[rootB];
+    v[rootB] = static_cast<std::int32_t>(rootA);
+    --sets;
+    return true;
   }
 
   /**
@@ -57,6 +118,40 @@ public:
    */
   bool find(size_t a, size_t b) { return root(a) == root(b); }
 
+  bool find(size_t a, size_t b) const { return root(a) == root(b); }
+
+  /**
+   * Add a new element in a set of its own.
+   * @return ID of the new element
+   */
+  size_t add() {
+    check_size(v.size() + 1);
+    v.push_back(-1);
+    ++sets;
+    return v.size() - 1;
+  }
+
+  /**
+   * Reserve space for a total of n elements.
+   * @param n Number of elements
+   */
+  void reserve(size_t n) { v.reserve(n); }
+
+  /**
+   * Get size of the set containing an element.
+   * @param  a Element
+   * @return   Number of elements in the set
+   */
+  size_t set_size(size_t a) const {
+    return static_cast<size_t>(-static_cast<std::int64_t>(v[root(a)]));
+  }
+
+  /**
+   * Get number of disjoint sets.
+   * @return Number of sets
+   */
+  size_t num_sets() const noexcept { return sets; }
+
   /**
    * Get number of elements.
    * @return Number of elements in data structure